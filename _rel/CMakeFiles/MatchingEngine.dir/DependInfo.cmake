@@ -0,0 +1,34 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/CommandParser.cpp" "CMakeFiles/MatchingEngine.dir/src/CommandParser.cpp.o" "gcc" "CMakeFiles/MatchingEngine.dir/src/CommandParser.cpp.o.d"
+  "/root/repo/src/CommandType.cpp" "CMakeFiles/MatchingEngine.dir/src/CommandType.cpp.o" "gcc" "CMakeFiles/MatchingEngine.dir/src/CommandType.cpp.o.d"
+  "/root/repo/src/Journal.cpp" "CMakeFiles/MatchingEngine.dir/src/Journal.cpp.o" "gcc" "CMakeFiles/MatchingEngine.dir/src/Journal.cpp.o.d"
+  "/root/repo/src/MarketDataPublisher.cpp" "CMakeFiles/MatchingEngine.dir/src/MarketDataPublisher.cpp.o" "gcc" "CMakeFiles/MatchingEngine.dir/src/MarketDataPublisher.cpp.o.d"
+  "/root/repo/src/MatchingEngine.cpp" "CMakeFiles/MatchingEngine.dir/src/MatchingEngine.cpp.o" "gcc" "CMakeFiles/MatchingEngine.dir/src/MatchingEngine.cpp.o.d"
+  "/root/repo/src/Order.cpp" "CMakeFiles/MatchingEngine.dir/src/Order.cpp.o" "gcc" "CMakeFiles/MatchingEngine.dir/src/Order.cpp.o.d"
+  "/root/repo/src/OrderBook.cpp" "CMakeFiles/MatchingEngine.dir/src/OrderBook.cpp.o" "gcc" "CMakeFiles/MatchingEngine.dir/src/OrderBook.cpp.o.d"
+  "/root/repo/src/Price.cpp" "CMakeFiles/MatchingEngine.dir/src/Price.cpp.o" "gcc" "CMakeFiles/MatchingEngine.dir/src/Price.cpp.o.d"
+  "/root/repo/src/RiskTable.cpp" "CMakeFiles/MatchingEngine.dir/src/RiskTable.cpp.o" "gcc" "CMakeFiles/MatchingEngine.dir/src/RiskTable.cpp.o.d"
+  "/root/repo/src/Runtime.cpp" "CMakeFiles/MatchingEngine.dir/src/Runtime.cpp.o" "gcc" "CMakeFiles/MatchingEngine.dir/src/Runtime.cpp.o.d"
+  "/root/repo/src/Snapshot.cpp" "CMakeFiles/MatchingEngine.dir/src/Snapshot.cpp.o" "gcc" "CMakeFiles/MatchingEngine.dir/src/Snapshot.cpp.o.d"
+  "/root/repo/src/Stats.cpp" "CMakeFiles/MatchingEngine.dir/src/Stats.cpp.o" "gcc" "CMakeFiles/MatchingEngine.dir/src/Stats.cpp.o.d"
+  "/root/repo/src/TradeAnalytics.cpp" "CMakeFiles/MatchingEngine.dir/src/TradeAnalytics.cpp.o" "gcc" "CMakeFiles/MatchingEngine.dir/src/TradeAnalytics.cpp.o.d"
+  "/root/repo/src/TraderBase.cpp" "CMakeFiles/MatchingEngine.dir/src/TraderBase.cpp.o" "gcc" "CMakeFiles/MatchingEngine.dir/src/TraderBase.cpp.o.d"
+  "/root/repo/src/Transaction.cpp" "CMakeFiles/MatchingEngine.dir/src/Transaction.cpp.o" "gcc" "CMakeFiles/MatchingEngine.dir/src/Transaction.cpp.o.d"
+  "/root/repo/src/TransactionList.cpp" "CMakeFiles/MatchingEngine.dir/src/TransactionList.cpp.o" "gcc" "CMakeFiles/MatchingEngine.dir/src/TransactionList.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
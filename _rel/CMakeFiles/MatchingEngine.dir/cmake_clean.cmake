@@ -0,0 +1,41 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/MatchingEngine.dir/src/CommandParser.cpp.o"
+  "CMakeFiles/MatchingEngine.dir/src/CommandParser.cpp.o.d"
+  "CMakeFiles/MatchingEngine.dir/src/CommandType.cpp.o"
+  "CMakeFiles/MatchingEngine.dir/src/CommandType.cpp.o.d"
+  "CMakeFiles/MatchingEngine.dir/src/Journal.cpp.o"
+  "CMakeFiles/MatchingEngine.dir/src/Journal.cpp.o.d"
+  "CMakeFiles/MatchingEngine.dir/src/MarketDataPublisher.cpp.o"
+  "CMakeFiles/MatchingEngine.dir/src/MarketDataPublisher.cpp.o.d"
+  "CMakeFiles/MatchingEngine.dir/src/MatchingEngine.cpp.o"
+  "CMakeFiles/MatchingEngine.dir/src/MatchingEngine.cpp.o.d"
+  "CMakeFiles/MatchingEngine.dir/src/Order.cpp.o"
+  "CMakeFiles/MatchingEngine.dir/src/Order.cpp.o.d"
+  "CMakeFiles/MatchingEngine.dir/src/OrderBook.cpp.o"
+  "CMakeFiles/MatchingEngine.dir/src/OrderBook.cpp.o.d"
+  "CMakeFiles/MatchingEngine.dir/src/Price.cpp.o"
+  "CMakeFiles/MatchingEngine.dir/src/Price.cpp.o.d"
+  "CMakeFiles/MatchingEngine.dir/src/RiskTable.cpp.o"
+  "CMakeFiles/MatchingEngine.dir/src/RiskTable.cpp.o.d"
+  "CMakeFiles/MatchingEngine.dir/src/Runtime.cpp.o"
+  "CMakeFiles/MatchingEngine.dir/src/Runtime.cpp.o.d"
+  "CMakeFiles/MatchingEngine.dir/src/Snapshot.cpp.o"
+  "CMakeFiles/MatchingEngine.dir/src/Snapshot.cpp.o.d"
+  "CMakeFiles/MatchingEngine.dir/src/Stats.cpp.o"
+  "CMakeFiles/MatchingEngine.dir/src/Stats.cpp.o.d"
+  "CMakeFiles/MatchingEngine.dir/src/TradeAnalytics.cpp.o"
+  "CMakeFiles/MatchingEngine.dir/src/TradeAnalytics.cpp.o.d"
+  "CMakeFiles/MatchingEngine.dir/src/TraderBase.cpp.o"
+  "CMakeFiles/MatchingEngine.dir/src/TraderBase.cpp.o.d"
+  "CMakeFiles/MatchingEngine.dir/src/Transaction.cpp.o"
+  "CMakeFiles/MatchingEngine.dir/src/Transaction.cpp.o.d"
+  "CMakeFiles/MatchingEngine.dir/src/TransactionList.cpp.o"
+  "CMakeFiles/MatchingEngine.dir/src/TransactionList.cpp.o.d"
+  "libMatchingEngine.a"
+  "libMatchingEngine.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/MatchingEngine.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/OrderMatchingEngine.dir/src/main.cpp.o"
+  "CMakeFiles/OrderMatchingEngine.dir/src/main.cpp.o.d"
+  "OrderMatchingEngine"
+  "OrderMatchingEngine.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/OrderMatchingEngine.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
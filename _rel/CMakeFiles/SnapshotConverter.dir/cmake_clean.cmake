@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/SnapshotConverter.dir/src/SnapshotConverter.cpp.o"
+  "CMakeFiles/SnapshotConverter.dir/src/SnapshotConverter.cpp.o.d"
+  "SnapshotConverter"
+  "SnapshotConverter.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/SnapshotConverter.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,21 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/benchmarks/OrderFlowGenerator.cpp" "CMakeFiles/benchmarks.dir/benchmarks/OrderFlowGenerator.cpp.o" "gcc" "CMakeFiles/benchmarks.dir/benchmarks/OrderFlowGenerator.cpp.o.d"
+  "/root/repo/benchmarks/benchOrderBook.cpp" "CMakeFiles/benchmarks.dir/benchmarks/benchOrderBook.cpp.o" "gcc" "CMakeFiles/benchmarks.dir/benchmarks/benchOrderBook.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_rel/CMakeFiles/MatchingEngine.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/benchmarks.dir/benchmarks/OrderFlowGenerator.cpp.o"
+  "CMakeFiles/benchmarks.dir/benchmarks/OrderFlowGenerator.cpp.o.d"
+  "CMakeFiles/benchmarks.dir/benchmarks/benchOrderBook.cpp.o"
+  "CMakeFiles/benchmarks.dir/benchmarks/benchOrderBook.cpp.o.d"
+  "benchmarks"
+  "benchmarks.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/benchmarks.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/generateOrderFlow.dir/benchmarks/OrderFlowGenerator.cpp.o"
+  "CMakeFiles/generateOrderFlow.dir/benchmarks/OrderFlowGenerator.cpp.o.d"
+  "CMakeFiles/generateOrderFlow.dir/benchmarks/generateOrderFlow.cpp.o"
+  "CMakeFiles/generateOrderFlow.dir/benchmarks/generateOrderFlow.cpp.o.d"
+  "generateOrderFlow"
+  "generateOrderFlow.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/generateOrderFlow.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,12 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/testMatching.dir/tests/testMatching.cpp.o"
+  "CMakeFiles/testMatching.dir/tests/testMatching.cpp.o.d"
+  "testMatching"
+  "testMatching.pdb"
+  "testMatching[1]_tests.cmake"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/testMatching.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
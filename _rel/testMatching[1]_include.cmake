@@ -0,0 +1,5 @@
+if(EXISTS "/root/repo/_rel/testMatching[1]_tests.cmake")
+  include("/root/repo/_rel/testMatching[1]_tests.cmake")
+else()
+  add_test(testMatching_NOT_BUILT testMatching_NOT_BUILT)
+endif()
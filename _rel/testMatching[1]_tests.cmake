@@ -0,0 +1,75 @@
+add_test([=[OrderBookTest.Match]=]  /root/repo/_rel/testMatching [==[--gtest_filter=OrderBookTest.Match]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[OrderBookTest.Match]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[OrderBookTest.NoMatch]=]  /root/repo/_rel/testMatching [==[--gtest_filter=OrderBookTest.NoMatch]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[OrderBookTest.NoMatch]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[OrderBookTest.PartialMatch]=]  /root/repo/_rel/testMatching [==[--gtest_filter=OrderBookTest.PartialMatch]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[OrderBookTest.PartialMatch]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[OrderBookTest.MultipleOrdersSomeMatch]=]  /root/repo/_rel/testMatching [==[--gtest_filter=OrderBookTest.MultipleOrdersSomeMatch]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[OrderBookTest.MultipleOrdersSomeMatch]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[OrderBookTest.FifoWithinPriceLevel]=]  /root/repo/_rel/testMatching [==[--gtest_filter=OrderBookTest.FifoWithinPriceLevel]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[OrderBookTest.FifoWithinPriceLevel]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[OrderBookTest.FullMatch]=]  /root/repo/_rel/testMatching [==[--gtest_filter=OrderBookTest.FullMatch]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[OrderBookTest.FullMatch]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[OrderBookTest.SameUserNoMatch]=]  /root/repo/_rel/testMatching [==[--gtest_filter=OrderBookTest.SameUserNoMatch]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[OrderBookTest.SameUserNoMatch]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[OrderBookTest.InvalidCommand]=]  /root/repo/_rel/testMatching [==[--gtest_filter=OrderBookTest.InvalidCommand]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[OrderBookTest.InvalidCommand]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[OrderBookTest.InvalidInput]=]  /root/repo/_rel/testMatching [==[--gtest_filter=OrderBookTest.InvalidInput]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[OrderBookTest.InvalidInput]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[OrderBookTest.FractionalPriceMatch]=]  /root/repo/_rel/testMatching [==[--gtest_filter=OrderBookTest.FractionalPriceMatch]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[OrderBookTest.FractionalPriceMatch]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[OrderBookTest.OffTickPriceRejected]=]  /root/repo/_rel/testMatching [==[--gtest_filter=OrderBookTest.OffTickPriceRejected]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[OrderBookTest.OffTickPriceRejected]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[OrderBookTest.OrderPoolRecycling]=]  /root/repo/_rel/testMatching [==[--gtest_filter=OrderBookTest.OrderPoolRecycling]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[OrderBookTest.OrderPoolRecycling]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[OrderBookTest.AggressiveOrderDoesNotRest]=]  /root/repo/_rel/testMatching [==[--gtest_filter=OrderBookTest.AggressiveOrderDoesNotRest]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[OrderBookTest.AggressiveOrderDoesNotRest]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[OrderBookTest.CancelOrder]=]  /root/repo/_rel/testMatching [==[--gtest_filter=OrderBookTest.CancelOrder]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[OrderBookTest.CancelOrder]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[OrderBookTest.CancelEmptiesBestLevel]=]  /root/repo/_rel/testMatching [==[--gtest_filter=OrderBookTest.CancelEmptiesBestLevel]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[OrderBookTest.CancelEmptiesBestLevel]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[OrderBookTest.AmendOrder]=]  /root/repo/_rel/testMatching [==[--gtest_filter=OrderBookTest.AmendOrder]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[OrderBookTest.AmendOrder]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[OrderBookTest.DepthLevels]=]  /root/repo/_rel/testMatching [==[--gtest_filter=OrderBookTest.DepthLevels]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[OrderBookTest.DepthLevels]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[OrderBookTest.PerformanceTest]=]  /root/repo/_rel/testMatching [==[--gtest_filter=OrderBookTest.PerformanceTest]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[OrderBookTest.PerformanceTest]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[CommandParserTest.ParseCommands]=]  /root/repo/_rel/testMatching [==[--gtest_filter=CommandParserTest.ParseCommands]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[CommandParserTest.ParseCommands]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[PriceTest.ParseAndFormat]=]  /root/repo/_rel/testMatching [==[--gtest_filter=PriceTest.ParseAndFormat]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[PriceTest.ParseAndFormat]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TraderBaseTest.Interning]=]  /root/repo/_rel/testMatching [==[--gtest_filter=TraderBaseTest.Interning]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TraderBaseTest.Interning]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[SpscQueueTest.TransfersInOrder]=]  /root/repo/_rel/testMatching [==[--gtest_filter=SpscQueueTest.TransfersInOrder]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[SpscQueueTest.TransfersInOrder]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[OrderTypeTest.ImmediateOrCancel]=]  /root/repo/_rel/testMatching [==[--gtest_filter=OrderTypeTest.ImmediateOrCancel]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[OrderTypeTest.ImmediateOrCancel]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[OrderTypeTest.FillOrKill]=]  /root/repo/_rel/testMatching [==[--gtest_filter=OrderTypeTest.FillOrKill]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[OrderTypeTest.FillOrKill]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[OrderTypeTest.MarketOrder]=]  /root/repo/_rel/testMatching [==[--gtest_filter=OrderTypeTest.MarketOrder]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[OrderTypeTest.MarketOrder]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[OrderTypeTest.PostOnly]=]  /root/repo/_rel/testMatching [==[--gtest_filter=OrderTypeTest.PostOnly]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[OrderTypeTest.PostOnly]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[OrderTypeTest.SelfTradePrevention]=]  /root/repo/_rel/testMatching [==[--gtest_filter=OrderTypeTest.SelfTradePrevention]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[OrderTypeTest.SelfTradePrevention]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[MatchingEngineTest.SubmitAndSubmitMany]=]  /root/repo/_rel/testMatching [==[--gtest_filter=MatchingEngineTest.SubmitAndSubmitMany]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[MatchingEngineTest.SubmitAndSubmitMany]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TradeAnalyticsTest.IncrementalAggregates]=]  /root/repo/_rel/testMatching [==[--gtest_filter=TradeAnalyticsTest.IncrementalAggregates]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TradeAnalyticsTest.IncrementalAggregates]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[RiskTest.PreTradeLimits]=]  /root/repo/_rel/testMatching [==[--gtest_filter=RiskTest.PreTradeLimits]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[RiskTest.PreTradeLimits]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[JournalTest.ReplayAfterTornWrite]=]  /root/repo/_rel/testMatching [==[--gtest_filter=JournalTest.ReplayAfterTornWrite]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[JournalTest.ReplayAfterTornWrite]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[SnapshotTest.RoundTrip]=]  /root/repo/_rel/testMatching [==[--gtest_filter=SnapshotTest.RoundTrip]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[SnapshotTest.RoundTrip]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[SeqlockTest.ConsistentReads]=]  /root/repo/_rel/testMatching [==[--gtest_filter=SeqlockTest.ConsistentReads]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[SeqlockTest.ConsistentReads]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TransactionListTest.PublishesBatches]=]  /root/repo/_rel/testMatching [==[--gtest_filter=TransactionListTest.PublishesBatches]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TransactionListTest.PublishesBatches]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[TransactionListTest.SpillsSealedBlocks]=]  /root/repo/_rel/testMatching [==[--gtest_filter=TransactionListTest.SpillsSealedBlocks]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[TransactionListTest.SpillsSealedBlocks]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[MarketDataPublisherTest.ConflatesUpdates]=]  /root/repo/_rel/testMatching [==[--gtest_filter=MarketDataPublisherTest.ConflatesUpdates]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[MarketDataPublisherTest.ConflatesUpdates]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[StatsTest.LatencyHistogramPercentiles]=]  /root/repo/_rel/testMatching [==[--gtest_filter=StatsTest.LatencyHistogramPercentiles]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[StatsTest.LatencyHistogramPercentiles]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_rel SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+set(  testMatching_TESTS OrderBookTest.Match OrderBookTest.NoMatch OrderBookTest.PartialMatch OrderBookTest.MultipleOrdersSomeMatch OrderBookTest.FifoWithinPriceLevel OrderBookTest.FullMatch OrderBookTest.SameUserNoMatch OrderBookTest.InvalidCommand OrderBookTest.InvalidInput OrderBookTest.FractionalPriceMatch OrderBookTest.OffTickPriceRejected OrderBookTest.OrderPoolRecycling OrderBookTest.AggressiveOrderDoesNotRest OrderBookTest.CancelOrder OrderBookTest.CancelEmptiesBestLevel OrderBookTest.AmendOrder OrderBookTest.DepthLevels OrderBookTest.PerformanceTest CommandParserTest.ParseCommands PriceTest.ParseAndFormat TraderBaseTest.Interning SpscQueueTest.TransfersInOrder OrderTypeTest.ImmediateOrCancel OrderTypeTest.FillOrKill OrderTypeTest.MarketOrder OrderTypeTest.PostOnly OrderTypeTest.SelfTradePrevention MatchingEngineTest.SubmitAndSubmitMany TradeAnalyticsTest.IncrementalAggregates RiskTest.PreTradeLimits JournalTest.ReplayAfterTornWrite SnapshotTest.RoundTrip SeqlockTest.ConsistentReads TransactionListTest.PublishesBatches TransactionListTest.SpillsSealedBlocks MarketDataPublisherTest.ConflatesUpdates StatsTest.LatencyHistogramPercentiles)
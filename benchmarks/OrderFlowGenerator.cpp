@@ -0,0 +1,66 @@
+#include "OrderFlowGenerator.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+OrderFlowGenerator::OrderFlowGenerator(const OrderFlowConfig& config, TraderBase& traderBase)
+    : config(config), random(config.seed),
+      // about 90% of passive orders land within priceLevels / 4 ticks of the mid
+      levelOffset(std::min(1.0, 10.0 / std::max(config.priceLevels, 1))) {
+    for (int i = 0; i < std::max(config.traderCount, 1); ++i) {
+        traderNames.push_back("T");
+        traderNames.back() += std::to_string(i);
+        traderIds.push_back(traderBase.addTrader(traderNames.back()));
+    }
+}
+
+Command OrderFlowGenerator::next() {
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::uniform_int_distribution<int> quantity(config.minQuantity, std::max(config.minQuantity, config.maxQuantity));
+    std::uniform_int_distribution<size_t> trader(0, traderIds.size() - 1);
+
+    bool isBuy = unit(random) < config.buyRatio;
+    bool crosses = unit(random) < config.crossingRatio;
+    Price offset = 1 + std::min(levelOffset(random), std::max(config.priceLevels, 1) - 1);
+    // a buy below the mid rests, a buy above it reaches into the asks
+    Price pricePerOne = config.midPrice + (isBuy == crosses ? offset : -offset);
+
+    Command command{isBuy ? CommandType::BUY : CommandType::SELL};
+    command.orderId = nextOrderId++;
+    command.trader = traderIds[trader(random)];
+    command.quantity = quantity(random);
+    command.pricePerOne = std::max<Price>(pricePerOne, 1);
+    return command;
+}
+
+std::vector<Command> OrderFlowGenerator::generate(size_t count) {
+    std::vector<Command> commands;
+    commands.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        commands.push_back(next());
+    }
+    return commands;
+}
+
+std::string OrderFlowGenerator::toCommandLine(const Command& command) const {
+    auto trader = std::find(traderIds.begin(), traderIds.end(), command.trader);
+    const std::string& name = trader != traderIds.end() ? traderNames[trader - traderIds.begin()] : traderNames[0];
+    return std::string(command.type == CommandType::BUY ? "buy " : "sell ") + name + " "
+         + formatPrice(command.pricePerOne * command.quantity) + " " + std::to_string(command.quantity);
+}
+
+bool OrderFlowGenerator::writeReplayFile(const std::string& filename, size_t count, time_t startTime) {
+    std::ofstream file(filename);
+    if(file.is_open()){
+        int perSecond = std::max(config.ordersPerSecond, 1);
+        for (size_t i = 0; i < count; ++i) {
+            file << startTime + static_cast<time_t>(i / perSecond) << ' ' << toCommandLine(next()) << '\n';
+        }
+        file.close();
+        return true;
+    }
+    else{
+        std::cerr << "Error opening a file: " << filename << std::endl;
+        return false;
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef ORDERFLOWGENERATOR_H
+#define ORDERFLOWGENERATOR_H
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include "CommandType.h"
+#include "TraderBase.h"
+
+// Shape of the synthetic order flow. Prices are in ticks.
+struct OrderFlowConfig {
+    uint64_t seed = 42;
+    int traderCount = 100;
+    Price midPrice = 10000;
+    // passive orders rest 1..priceLevels ticks away from the mid price,
+    // nearer prices being more likely
+    int priceLevels = 50;
+    // share of orders priced up to priceLevels ticks through the mid
+    // price, which usually makes them match on arrival
+    double crossingRatio = 0.2;
+    double buyRatio = 0.5;
+    int minQuantity = 1;
+    int maxQuantity = 100;
+    // logical time between consecutive orders in replay files
+    int ordersPerSecond = 1000;
+};
+
+// Seeded, reproducible stream of limit buy and sell orders for benchmarks.
+// Traders are registered in the given TraderBase as "T0", "T1", ...
+class OrderFlowGenerator {
+public:
+    OrderFlowGenerator(const OrderFlowConfig& config, TraderBase& traderBase);
+
+    // next order; ids count up from 1
+    Command next();
+    std::vector<Command> generate(size_t count);
+
+    // Write `count` orders as "<timestamp> <command>" lines, the command
+    // in the engine's input syntax. Timestamps start at `startTime`.
+    bool writeReplayFile(const std::string& filename, size_t count, time_t startTime);
+
+    // the order in the engine's input syntax, e.g. "buy T3 250 5"
+    std::string toCommandLine(const Command& command) const;
+
+private:
+    OrderFlowConfig config;
+    std::vector<std::string> traderNames;
+    std::vector<TraderId> traderIds;
+    std::mt19937_64 random;
+    std::geometric_distribution<int> levelOffset;
+    OrderId nextOrderId = 1;
+};
+
+#endif // ORDERFLOWGENERATOR_H
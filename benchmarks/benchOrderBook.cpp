@@ -0,0 +1,216 @@
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <span>
+#include <vector>
+#include "OrderFlowGenerator.h"
+#include "CommandParser.h"
+#include "Instrument.h"
+#include "MatchingEngine.h"
+#include "OrderBook.h"
+#include "TransactionList.h"
+
+// Benchmarks of the order book and the matching path. Run with
+// --benchmark_format=json (or =csv) to keep the numbers of a build and
+// compare them with benchmark's tools/compare.py.
+
+static constexpr int BATCH = 4096;
+
+// resting orders of one side only, so nothing matches
+static std::vector<Command> passiveOrders(TraderBase& traderBase, bool isBuy, size_t count) {
+    OrderFlowConfig config;
+    config.crossingRatio = 0.0;
+    config.buyRatio = isBuy ? 1.0 : 0.0;
+    return OrderFlowGenerator(config, traderBase).generate(count);
+}
+
+static void addOrder(OrderBook& orderBook, const Command& command, bool isBuy) {
+    OrderPtr order = orderBook.createOrder(command.orderId, command.quantity, command.pricePerOne, 0, command.trader);
+    if (isBuy) {
+        orderBook.addBuyOrder(std::move(order));
+    } else {
+        orderBook.addSellOrder(std::move(order));
+    }
+}
+
+// Adding orders to a book that already holds state.range(0) orders
+template <bool IsBuy>
+static void BM_AddOrder(benchmark::State& state) {
+    TraderBase traderBase;
+    std::vector<Command> orders = passiveOrders(traderBase, IsBuy, state.range(0) + BATCH);
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto orderBook = std::make_unique<OrderBook>();
+        for (int64_t i = 0; i < state.range(0); ++i) {
+            addOrder(*orderBook, orders[BATCH + i], IsBuy);
+        }
+        state.ResumeTiming();
+        for (int i = 0; i < BATCH; ++i) {
+            addOrder(*orderBook, orders[i], IsBuy);
+        }
+        state.PauseTiming();
+        orderBook.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * BATCH);
+}
+BENCHMARK_TEMPLATE(BM_AddOrder, true)->Name("BM_AddBuyOrder")->Arg(0)->Arg(100000);
+BENCHMARK_TEMPLATE(BM_AddOrder, false)->Name("BM_AddSellOrder")->Arg(0)->Arg(100000);
+
+// Popping the best order until the book is empty
+template <bool IsBuy>
+static void BM_PopOrder(benchmark::State& state) {
+    TraderBase traderBase;
+    std::vector<Command> orders = passiveOrders(traderBase, IsBuy, BATCH);
+    OrderBook orderBook;
+    for (auto _ : state) {
+        state.PauseTiming();
+        for (const Command& command : orders) {
+            addOrder(orderBook, command, IsBuy);
+        }
+        state.ResumeTiming();
+        for (int i = 0; i < BATCH; ++i) {
+            if (IsBuy) {
+                orderBook.popBuyOrder();
+            } else {
+                orderBook.popSellOrder();
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * BATCH);
+}
+BENCHMARK_TEMPLATE(BM_PopOrder, true)->Name("BM_PopBuyOrder");
+BENCHMARK_TEMPLATE(BM_PopOrder, false)->Name("BM_PopSellOrder");
+
+// Reading the best order of a book holding state.range(0) orders
+template <bool IsBuy>
+static void BM_FrontOrder(benchmark::State& state) {
+    TraderBase traderBase;
+    OrderBook orderBook;
+    for (const Command& command : passiveOrders(traderBase, IsBuy, state.range(0))) {
+        addOrder(orderBook, command, IsBuy);
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(IsBuy ? orderBook.getFrontBuyOrder() : orderBook.getFrontSellOrder());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_FrontOrder, true)->Name("BM_FrontBuyOrder")->Arg(100000);
+BENCHMARK_TEMPLATE(BM_FrontOrder, false)->Name("BM_FrontSellOrder")->Arg(100000);
+
+// Full matching path (MatchingEngine::submit) over a mixed order flow. Arguments:
+// crossing ratio in percent and trader count. Passive orders accumulate, so
+// the flow is kept short and every pass over it starts again from an empty
+// book (outside the timing); each pass then measures the same book sizes.
+static void BM_MatchLoop(benchmark::State& state) {
+    OrderFlowConfig config;
+    config.crossingRatio = state.range(0) / 100.0;
+    config.traderCount = static_cast<int>(state.range(1));
+    TraderBase traderBase;
+    const size_t flowSize = 1 << 16;
+    std::vector<Command> flow = OrderFlowGenerator(config, traderBase).generate(flowSize);
+    auto instrument = std::make_unique<Instrument>(0, "BENCH", "");
+    size_t next = 0;
+    uint64_t fills = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(instrument->engine.submit(flow[next], 0).status);
+        if (++next == flowSize) {
+            state.PauseTiming();
+            fills += instrument->txList.getSize();
+            instrument = std::make_unique<Instrument>(0, "BENCH", "");
+            next = 0;
+            state.ResumeTiming();
+        }
+    }
+    fills += instrument->txList.getSize();
+    state.SetItemsProcessed(state.iterations());
+    state.counters["fills"] = benchmark::Counter(static_cast<double>(fills), benchmark::Counter::kIsRate);
+    state.counters["resting"] = static_cast<double>(instrument->orderBook.getOrderPoolStats().live);
+}
+BENCHMARK(BM_MatchLoop)->ArgNames({"crossPct", "traders"})->Args({10, 100})->Args({50, 100})->Args({50, 2});
+
+// One aggressive buy order sweeping state.range(0) sell levels of one
+// order each, every 1 or state.range(1) ticks apart; items are levels emptied
+static void BM_SweepLevels(benchmark::State& state) {
+    const int levels = static_cast<int>(state.range(0));
+    const Price spacing = state.range(1);
+    OrderBook orderBook;
+    TransactionList txList;
+    MatchingEngine engine(orderBook, txList);
+    OrderId id = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        for (int i = 0; i < levels; ++i) {
+            orderBook.addSellOrder(orderBook.createOrder(++id, 1, 10000 + i * spacing, 0, 1));
+        }
+        Command sweep{};
+        sweep.type = CommandType::BUY;
+        sweep.orderId = ++id;
+        sweep.quantity = levels;
+        sweep.pricePerOne = 10000 + levels * spacing;
+        sweep.trader = 2;
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(engine.submit(sweep, 0).status);
+    }
+    state.SetItemsProcessed(state.iterations() * levels);
+}
+BENCHMARK(BM_SweepLevels)->ArgNames({"levels", "spacing"})->Args({1000, 1})->Args({1000, 16});
+
+// The same flow submitted state.range(0) commands at a time (submitMany),
+// restarting from an empty book after every pass like BM_MatchLoop
+static void BM_SubmitMany(benchmark::State& state) {
+    OrderFlowConfig config;
+    config.crossingRatio = 0.5;
+    TraderBase traderBase;
+    const size_t flowSize = 1 << 16;
+    const size_t batchSize = static_cast<size_t>(state.range(0));
+    std::vector<Command> flow = OrderFlowGenerator(config, traderBase).generate(flowSize);
+    auto instrument = std::make_unique<Instrument>(0, "BENCH", "");
+    std::vector<CommandStatus> statuses(batchSize);
+    size_t next = 0;
+    for (auto _ : state) {
+        std::span<const Command> batch(flow.data() + next, batchSize);
+        benchmark::DoNotOptimize(instrument->engine.submitMany(batch, 0, statuses).size());
+        next += batchSize;
+        if (next + batchSize > flowSize) {
+            state.PauseTiming();
+            instrument = std::make_unique<Instrument>(0, "BENCH", "");
+            next = 0;
+            state.ResumeTiming();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * batchSize);
+}
+BENCHMARK(BM_SubmitMany)->Arg(1)->Arg(16)->Arg(256);
+
+// Parsing generated "buy" / "sell" lines, as the input thread does
+static void BM_ParseCommand(benchmark::State& state) {
+    TraderBase traderBase;
+    OrderFlowGenerator generator(OrderFlowConfig{}, traderBase);
+    std::vector<std::string> lines;
+    for (const Command& command : generator.generate(BATCH)) {
+        lines.push_back(generator.toCommandLine(command));
+    }
+    ParsedCommand parsed;
+    size_t next = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parseCommand(lines[next], parsed));
+        next = (next + 1) % lines.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ParseCommand);
+
+// txlist: the last state.range(0) of 1.000.000 transactions
+static void BM_GetLastN(benchmark::State& state) {
+    TransactionList txList;
+    for (int i = 0; i < 1000000; ++i) {
+        txList.addTransaction(Transaction(1, 100 + i % 50, i, i % 7, i % 11));
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(txList.getLastN(static_cast<int>(state.range(0))));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GetLastN)->Arg(5)->Arg(100)->Arg(10000);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,63 @@
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include "OrderFlowGenerator.h"
+
+// Writes a synthetic order flow as a replay file.
+//
+//   generateOrderFlow <file> <count> [--seed N] [--traders N] [--mid N]
+//                     [--levels N] [--crossing R] [--buy-ratio R]
+//                     [--min-quantity N] [--max-quantity N] [--rate N]
+//                     [--start-time T]
+//
+// Prices (--mid, in ticks) follow the engine's default price configuration.
+// The same arguments always produce the same file.
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <file> <count> [options]" << std::endl;
+        return 1;
+    }
+    std::string filename = argv[1];
+    size_t count = std::strtoull(argv[2], nullptr, 10);
+    OrderFlowConfig config;
+    time_t startTime = 1700000000;
+    for (int i = 3; i + 1 < argc; i += 2) {
+        const char* value = argv[i + 1];
+        if (std::strcmp(argv[i], "--seed") == 0) {
+            config.seed = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(argv[i], "--traders") == 0) {
+            config.traderCount = std::atoi(value);
+        } else if (std::strcmp(argv[i], "--mid") == 0) {
+            config.midPrice = std::atoll(value);
+        } else if (std::strcmp(argv[i], "--levels") == 0) {
+            config.priceLevels = std::atoi(value);
+        } else if (std::strcmp(argv[i], "--crossing") == 0) {
+            config.crossingRatio = std::atof(value);
+        } else if (std::strcmp(argv[i], "--buy-ratio") == 0) {
+            config.buyRatio = std::atof(value);
+        } else if (std::strcmp(argv[i], "--min-quantity") == 0) {
+            config.minQuantity = std::atoi(value);
+        } else if (std::strcmp(argv[i], "--max-quantity") == 0) {
+            config.maxQuantity = std::atoi(value);
+        } else if (std::strcmp(argv[i], "--rate") == 0) {
+            config.ordersPerSecond = std::atoi(value);
+        } else if (std::strcmp(argv[i], "--start-time") == 0) {
+            startTime = std::atoll(value);
+        } else {
+            std::cerr << "Unknown argument: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+    if ((argc - 3) % 2 != 0) {
+        std::cerr << "Missing value for " << argv[argc - 1] << std::endl;
+        return 1;
+    }
+    if (startTime <= 0) {
+        std::cerr << "The start time must be positive: replay lines need a timestamp above 0" << std::endl;
+        return 1;
+    }
+
+    TraderBase traderBase;
+    OrderFlowGenerator generator(config, traderBase);
+    return generator.writeReplayFile(filename, count, startTime) ? 0 : 1;
+}
@@ -0,0 +1,138 @@
+#include "CommandParser.h"
+#include <format>
+#include "Tokenizer.h"
+
+// buy / sell arguments after the optional symbol
+static ParseError parseOrder(Tokenizer& tokens, ParsedCommand& command) {
+    std::string_view totalPriceText;
+    if (!tokens.next(command.trader) || !tokens.next(totalPriceText) || !nextNumber(tokens, command.quantity)) {
+        return ParseError::MISSING_ORDER_ARGUMENTS;
+    }
+    if (command.quantity <= 0) return ParseError::INVALID_QUANTITY;
+    if (totalPriceText == "market") {
+        command.orderType = OrderType::MARKET;
+        return ParseError::NONE;
+    }
+
+    int64_t totalPrice;
+    if (!parsePriceUnits(totalPriceText, totalPrice)) return ParseError::MISSING_ORDER_ARGUMENTS;
+    if (totalPrice <= 0) return ParseError::INVALID_TOTAL_PRICE;
+    if (!totalPriceToTicks(totalPrice, command.quantity, command.pricePerOne)) return ParseError::PRICE_NOT_IN_TICKS;
+    std::string_view orderTypeText;
+    if (tokens.next(orderTypeText) && !parseOrderType(orderTypeText, command.orderType)) {
+        command.invalidToken = orderTypeText;
+        return ParseError::UNKNOWN_ORDER_TYPE;
+    }
+    return ParseError::NONE;
+}
+
+// arguments of a command after the optional symbol
+static ParseError parseArguments(Tokenizer& tokens, ParsedCommand& command) {
+    switch (command.type) {
+        // the username is required: the engine lets only the order's owner change it
+        case CommandType::CANCEL:
+            return tokens.next(command.trader) && nextNumber(tokens, command.orderId) ? ParseError::NONE : ParseError::MISSING_ORDER_ID;
+        case CommandType::AMEND:
+            if (!tokens.next(command.trader) || !nextNumber(tokens, command.orderId) || !nextNumber(tokens, command.quantity)) {
+                return ParseError::MISSING_AMEND_ARGUMENTS;
+            }
+            return command.quantity > 0 ? ParseError::NONE : ParseError::INVALID_QUANTITY;
+        case CommandType::DEPTH:
+            return nextNumber(tokens, command.levels) && command.levels > 0 ? ParseError::NONE : ParseError::MISSING_DEPTH_LEVELS;
+        case CommandType::CANDLES: {
+            std::string_view intervalText;
+            if (!tokens.next(intervalText) || !parseInterval(intervalText, command.interval)
+                || !nextNumber(tokens, command.levels) || command.levels <= 0) {
+                return ParseError::MISSING_CANDLE_ARGUMENTS;
+            }
+            return ParseError::NONE;
+        }
+        case CommandType::VOLUME:
+        case CommandType::POSITION:
+            return tokens.next(command.trader) ? ParseError::NONE : ParseError::MISSING_USERNAME;
+        case CommandType::BUY:
+        case CommandType::SELL:
+            return parseOrder(tokens, command);
+        default:
+            return ParseError::NONE;
+    }
+}
+
+ParseError parseCommand(std::string_view line, ParsedCommand& command) {
+    command = ParsedCommand{};
+    Tokenizer tokens(line);
+    std::string_view token;
+    if (!tokens.next(token)) return ParseError::EMPTY;
+    if (!parseCommandType(token, command.type)) {
+        command.invalidToken = token;
+        return ParseError::UNKNOWN_COMMAND;
+    }
+
+    // optional "@SYMBOL"
+    if (command.type != CommandType::STATS && command.type != CommandType::EXIT) {
+        Tokenizer afterType = tokens;
+        if (tokens.next(token) && token[0] == '@') {
+            if (token.size() == 1) return ParseError::MISSING_SYMBOL;
+            command.symbol = token.substr(1);
+        } else {
+            tokens = afterType;
+        }
+    }
+
+    ParseError error = parseArguments(tokens, command);
+    // nothing may follow a complete command
+    if (error == ParseError::NONE && tokens.next(token)) {
+        command.invalidToken = token;
+        return ParseError::UNEXPECTED_ARGUMENT;
+    }
+    return error;
+}
+
+ParseError parseReplayLine(std::string_view line, ParsedCommand& command) {
+    Tokenizer tokens(line);
+    std::string_view token;
+    time_t timestamp;
+    if (!tokens.next(token)) return ParseError::EMPTY;
+    // 0 would stand for "now" and make the replay depend on the wall clock
+    if (!parseNumber(token, timestamp) || timestamp <= 0) return ParseError::INVALID_TIMESTAMP;
+    ParseError error = parseCommand(tokens.remaining(), command);
+    command.timestamp = timestamp;
+    return error;
+}
+
+std::string describeParseError(ParseError error, const ParsedCommand& command) {
+    switch (error) {
+        case ParseError::NONE:
+        case ParseError::EMPTY:
+            return "";
+        case ParseError::INVALID_TIMESTAMP:
+            return "Error: Invalid input. Replay lines must start with a positive timestamp";
+        case ParseError::UNKNOWN_COMMAND:
+            return std::format("Invalid command: \"{}\"", command.invalidToken);
+        case ParseError::MISSING_ORDER_ID:
+            return "Error: Invalid input. Please provide your username and the id of the order to cancel";
+        case ParseError::MISSING_AMEND_ARGUMENTS:
+            return "Error: Invalid input. Please provide your username, the order id and its new quantity";
+        case ParseError::MISSING_ORDER_ARGUMENTS:
+            return "Error: Invalid input. Please provide your username, totalPrice and quantity to create order";
+        case ParseError::INVALID_QUANTITY:
+            return "Quantity must be greater than 0.";
+        case ParseError::INVALID_TOTAL_PRICE:
+            return "Total Price must be greater than 0.";
+        case ParseError::PRICE_NOT_IN_TICKS:
+            return std::format("Price per item must be a whole number of ticks (tick size: {}).", formatPrice(1));
+        case ParseError::UNKNOWN_ORDER_TYPE:
+            return std::format("Invalid order type: \"{}\"", command.invalidToken);
+        case ParseError::MISSING_DEPTH_LEVELS:
+            return "Error: Invalid input. Please provide the number of price levels to show";
+        case ParseError::MISSING_CANDLE_ARGUMENTS:
+            return "Error: Invalid input. Please provide the candle interval (e.g. 1m) and the number of candles to show";
+        case ParseError::MISSING_USERNAME:
+            return "Error: Invalid input. Please provide the username";
+        case ParseError::MISSING_SYMBOL:
+            return "Error: Invalid input. Please provide the symbol after \"@\"";
+        case ParseError::UNEXPECTED_ARGUMENT:
+            return std::format("Error: Invalid input. Unexpected argument: \"{}\"", command.invalidToken);
+    }
+    return "";
+}
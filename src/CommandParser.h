@@ -0,0 +1,71 @@
+#ifndef COMMANDPARSER_H
+#define COMMANDPARSER_H
+
+#include <string>
+#include <string_view>
+#include "CommandType.h"
+
+// why a command line was rejected
+enum class ParseError {
+    NONE,
+    EMPTY,                    // nothing but whitespace
+    INVALID_TIMESTAMP,        // replay line not starting with a positive timestamp
+    UNKNOWN_COMMAND,
+    MISSING_ORDER_ID,         // cancel without a username and an order id
+    MISSING_AMEND_ARGUMENTS,  // amend without a username, an order id and a quantity
+    MISSING_ORDER_ARGUMENTS,  // buy / sell without username, total price and quantity
+    INVALID_QUANTITY,         // zero or negative
+    INVALID_TOTAL_PRICE,      // zero or negative
+    PRICE_NOT_IN_TICKS,       // price per item is not a whole number of ticks
+    UNKNOWN_ORDER_TYPE,
+    MISSING_DEPTH_LEVELS,     // depth without a positive number of levels
+    MISSING_CANDLE_ARGUMENTS, // candles without an interval and a positive count
+    MISSING_USERNAME,         // volume / position without a username
+    MISSING_SYMBOL,           // "@" without a symbol name
+    UNEXPECTED_ARGUMENT       // more arguments than the command takes
+};
+
+// A command as typed. The string views point into the parsed line and are
+// only valid as long as it is; trader and symbol names are resolved to ids
+// by the caller.
+struct ParsedCommand {
+    CommandType type = CommandType::EXIT;
+    std::string_view symbol; // without the '@'; empty for the default symbol
+    std::string_view trader; // placing the order, or owning the order to cancel / amend
+    OrderId orderId = 0;     // order to cancel / amend
+    int quantity = 0;
+    Price pricePerOne = 0;   // in ticks
+    OrderType orderType = OrderType::LIMIT;
+    int levels = 0;          // price levels per side to show (depth), candles to show (candles)
+    int64_t interval = 0;    // candle interval in seconds
+    time_t timestamp = 0;    // replay lines only
+    std::string_view invalidToken; // for UNKNOWN_COMMAND, UNKNOWN_ORDER_TYPE and UNEXPECTED_ARGUMENT
+};
+
+// Parse one command without allocating:
+//   buy/sell [@SYMBOL] <username> <totalPrice> <quantity> [limit|ioc|fok|post]
+//   buy/sell [@SYMBOL] <username> market <quantity>
+//   cancel [@SYMBOL] <username> <orderId>
+//   amend [@SYMBOL] <username> <orderId> <quantity>
+//   txlist [@SYMBOL]
+//   depth [@SYMBOL] <levels>
+//   candles [@SYMBOL] <interval> <count>   (interval: 30s, 1m, 1h, 1d, ...)
+//   vwap [@SYMBOL]
+//   volume [@SYMBOL] <username>
+//   position [@SYMBOL] <username>
+//   stats
+//   exit
+// cancel and amend name the trader owning the order, like buy and sell
+// name the one placing it: the console has no login, so the name is the
+// only way to tell an owner's cancel from anyone else's, and a bare
+// "cancel <orderId>" would let every user change every order.
+ParseError parseCommand(std::string_view line, ParsedCommand& command);
+
+// Parse a line of a replay file: "<timestamp> <command>", the timestamp
+// in seconds since the epoch and greater than 0
+ParseError parseReplayLine(std::string_view line, ParsedCommand& command);
+
+// message shown to the user for a rejected line
+std::string describeParseError(ParseError error, const ParsedCommand& command);
+
+#endif // COMMANDPARSER_H
@@ -1,11 +1,58 @@
 #include "CommandType.h"
-#include <format>
-
-// Convert string to CommandType enum
-CommandType getOrderTypeFromString(const std::string& type) {
-    if (type == "buy") return CommandType::BUY;
-    if (type == "sell") return CommandType::SELL;
-    if (type == "txlist") return CommandType::TXLIST;
-    if (type == "exit") return CommandType::EXIT;
-    throw std::invalid_argument(std::format("Invalid command: \"{}\"", type));
-}
\ No newline at end of file
+#include <charconv>
+
+bool parseCommandType(std::string_view text, CommandType& type) {
+    if (text == "buy") type = CommandType::BUY;
+    else if (text == "sell") type = CommandType::SELL;
+    else if (text == "cancel") type = CommandType::CANCEL;
+    else if (text == "amend") type = CommandType::AMEND;
+    else if (text == "txlist") type = CommandType::TXLIST;
+    else if (text == "depth") type = CommandType::DEPTH;
+    else if (text == "candles") type = CommandType::CANDLES;
+    else if (text == "vwap") type = CommandType::VWAP;
+    else if (text == "volume") type = CommandType::VOLUME;
+    else if (text == "position") type = CommandType::POSITION;
+    else if (text == "stats") type = CommandType::STATS;
+    else if (text == "exit") type = CommandType::EXIT;
+    else return false;
+    return true;
+}
+
+bool parseOrderType(std::string_view text, OrderType& type) {
+    if (text == "limit") type = OrderType::LIMIT;
+    else if (text == "ioc") type = OrderType::IOC;
+    else if (text == "fok") type = OrderType::FOK;
+    else if (text == "post") type = OrderType::POST_ONLY;
+    else return false;
+    return true;
+}
+
+bool parseSelfTradePrevention(std::string_view text, SelfTradePrevention& policy) {
+    if (text == "cancel-newest") policy = SelfTradePrevention::CANCEL_NEWEST;
+    else if (text == "cancel-oldest") policy = SelfTradePrevention::CANCEL_OLDEST;
+    else if (text == "cancel-both") policy = SelfTradePrevention::CANCEL_BOTH;
+    else if (text == "decrement") policy = SelfTradePrevention::DECREMENT;
+    else return false;
+    return true;
+}
+
+bool parseInterval(std::string_view text, int64_t& seconds) {
+    int64_t count;
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), count);
+    if (error != std::errc() || count <= 0 || end + 1 != text.data() + text.size()) return false;
+    switch (*end) {
+        case 's': seconds = count; break;
+        case 'm': seconds = count * 60; break;
+        case 'h': seconds = count * 3600; break;
+        case 'd': seconds = count * 86400; break;
+        default: return false;
+    }
+    return true;
+}
+
+std::string formatInterval(int64_t seconds) {
+    if (seconds % 86400 == 0) return std::to_string(seconds / 86400) + "d";
+    if (seconds % 3600 == 0) return std::to_string(seconds / 3600) + "h";
+    if (seconds % 60 == 0) return std::to_string(seconds / 60) + "m";
+    return std::to_string(seconds) + "s";
+}
@@ -2,10 +2,59 @@
 #define COMMANDTYPE_H
 
 #include <string>
-#include <stdexcept>
+#include <string_view>
+#include "Order.h"
 
-enum class CommandType { BUY, SELL, TXLIST, EXIT };
+enum class CommandType { BUY, SELL, CANCEL, AMEND, TXLIST, DEPTH, CANDLES, VWAP, VOLUME, POSITION, STATS, EXIT };
 
-CommandType getOrderTypeFromString(const std::string& type);
+// command name as typed ("buy", "txlist", ...); false for an unknown one
+bool parseCommandType(std::string_view text, CommandType& type);
 
-#endif
\ No newline at end of file
+// order type / time in force of a buy or sell order
+enum class OrderType {
+    LIMIT,     // rest any unfilled quantity in the book
+    MARKET,    // match at any price, never rest
+    IOC,       // immediate-or-cancel: match up to the limit, never rest
+    FOK,       // fill-or-kill: fill completely up to the limit or do nothing
+    POST_ONLY  // rest only; rejected if it would match on arrival
+};
+
+// optional order type suffix of buy / sell commands ("ioc", "post", ...)
+bool parseOrderType(std::string_view text, OrderType& type);
+
+// what happens when an incoming order meets a resting order of its own trader
+enum class SelfTradePrevention : uint8_t {
+    CANCEL_NEWEST, // cancel the rest of the incoming order
+    CANCEL_OLDEST, // cancel the resting order and keep matching
+    CANCEL_BOTH,   // cancel the resting order and the rest of the incoming one
+    DECREMENT      // reduce both by the smaller quantity, without a trade
+};
+
+// "cancel-newest", "cancel-oldest", "cancel-both" or "decrement"
+bool parseSelfTradePrevention(std::string_view text, SelfTradePrevention& policy);
+
+// candle interval: a number of seconds, minutes, hours or days ("30s",
+// "1m", "4h", "1d"); false unless it is a positive whole interval
+bool parseInterval(std::string_view text, int64_t& seconds);
+// the shortest such text for an interval
+std::string formatInterval(int64_t seconds);
+
+// index of an instrument in the engine's symbol list
+using SymbolId = uint32_t;
+
+// Fixed-size, already validated command passed from the input thread to
+// the matching thread, so the text is parsed only once.
+struct Command {
+    CommandType type;
+    OrderId orderId = 0; // new order's id, or the order to cancel / amend
+    TraderId trader = 0;
+    int quantity = 0;      // number of candles for CANDLES
+    Price pricePerOne = 0; // in ticks; the interval in seconds for CANDLES
+    OrderType orderType = OrderType::LIMIT;
+    SymbolId symbol = 0;
+    SelfTradePrevention selfTrade = SelfTradePrevention::CANCEL_NEWEST;
+    time_t timestamp = 0;   // logical time of a replayed command; 0: the time it is processed
+    int64_t receivedAt = 0; // steadyNanoseconds() when the line was read, for latency statistics
+};
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef INSTRUMENT_H
+#define INSTRUMENT_H
+
+#include <string>
+#include "CommandType.h"
+#include "MatchingEngine.h"
+#include "OrderBook.h"
+#include "RiskTable.h"
+#include "Seqlock.h"
+#include "Snapshot.h"
+#include "Stats.h"
+#include "TradeAnalytics.h"
+#include "TransactionList.h"
+
+// Everything the engine keeps for one traded symbol. The book is only
+// touched, through `engine`, by the matching thread of the shard owning
+// the symbol; the input thread reads the published part of the
+// transaction list, and the book's depth from `depth`, which the matching
+// thread refreshes after every command. Neither read takes a lock.
+// Without a directory the history is kept in memory only.
+struct Instrument {
+    Instrument(SymbolId id, std::string symbol, const std::string& directory)
+        : id(id), symbol(std::move(symbol)), directory(directory),
+          txList(directory.empty() ? "" : directory + "/history.bin"),
+          snapshot(directory + "/snapshot.bin", directory + "/transactions.bin") {}
+    Instrument(const Instrument&) = delete;
+    Instrument& operator=(const Instrument&) = delete;
+
+    SymbolId id;
+    std::string symbol;
+    std::string directory; // storage of this symbol
+    OrderBook orderBook;
+    TransactionList txList;
+    TradeAnalytics analytics; // kept up to date by the engine
+    RiskTable risk;           // likewise, and checked by it
+    MatchingEngine engine{orderBook, txList, &analytics, &risk};
+    Snapshot snapshot;
+    size_t topOfBook = 0;  // book index in the market data publisher
+    OrderId lastOrderId = 0;
+    InstrumentStats stats;
+    Seqlock<BookDepth> depth;
+};
+
+// shard whose matching thread owns `symbol`: symbols are dealt out in
+// turn, so for a given shard count a symbol always lands on the same one
+inline size_t shardOf(SymbolId symbol, size_t shardCount) {
+    return symbol % shardCount;
+}
+
+#endif // INSTRUMENT_H
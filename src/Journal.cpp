@@ -0,0 +1,277 @@
+#include "Journal.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+static const char JOURNAL_MAGIC[8] = {'O', 'M', 'E', 'J', 'N', 'L', '0', '2'};
+// the first format; its records end before the sequence number
+static const char JOURNAL_MAGIC_V1[8] = {'O', 'M', 'E', 'J', 'N', 'L', '0', '1'};
+static const size_t RECORD_SIZE_V1 = offsetof(JournalRecord, sequence);
+
+// FNV-1a, enough to detect a torn or garbled record
+static uint32_t checksum(const void* data, size_t size, uint32_t hash = 2166136261u) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t recordChecksum(JournalRecord record, const std::string& name, size_t recordSize = sizeof(JournalRecord)) {
+    record.checksum = 0;
+    return checksum(name.data(), name.size(), checksum(&record, recordSize));
+}
+
+// push written data from the C library to the OS and then to the disk
+static void syncFile(std::FILE* file) {
+    std::fflush(file);
+#ifdef _WIN32
+    _commit(_fileno(file));
+#else
+    fsync(fileno(file));
+#endif
+}
+
+JournalRecord makeCommandRecord(const Command& command, time_t timestamp) {
+    JournalRecord record{};
+    switch (command.type) {
+        case CommandType::CANCEL: record.type = JournalRecordType::CANCEL; break;
+        case CommandType::AMEND: record.type = JournalRecordType::AMEND; break;
+        default: record.type = JournalRecordType::ORDER; break;
+    }
+    record.side = static_cast<uint8_t>(command.type);
+    record.orderType = static_cast<uint8_t>(command.orderType);
+    record.selfTrade = static_cast<uint8_t>(command.selfTrade);
+    record.quantity = command.quantity;
+    record.trader = command.trader;
+    record.orderId = command.orderId;
+    record.pricePerOne = command.pricePerOne;
+    record.timestamp = timestamp;
+    record.symbol = command.symbol;
+    return record;
+}
+
+Command commandFromRecord(const JournalRecord& record) {
+    Command command{static_cast<CommandType>(record.side)};
+    command.orderId = record.orderId;
+    command.trader = record.trader;
+    command.quantity = record.quantity;
+    command.pricePerOne = record.pricePerOne;
+    command.orderType = static_cast<OrderType>(record.orderType);
+    command.selfTrade = static_cast<SelfTradePrevention>(record.selfTrade);
+    command.symbol = record.symbol;
+    return command;
+}
+
+Journal::~Journal() {
+    close();
+}
+
+void Journal::setGroupCommit(size_t maxRecords, std::chrono::microseconds maxDelay) {
+    groupCommitSize = maxRecords > 0 ? maxRecords : 1;
+    groupCommitDelay = maxDelay;
+}
+
+bool Journal::open(const std::string& filename, const TraderBase& traders, const std::vector<std::string>& symbols, bool truncate) {
+    close();
+    file = std::fopen(filename.c_str(), truncate ? "wb" : "ab");
+    if (!file) {
+        std::cerr << "Error opening a file: " << filename << std::endl;
+        return false;
+    }
+    traderBase = &traders;
+    // trader ids are only meaningful within one process, so every session
+    // names the traders it refers to again
+    journaledTraders = 0;
+
+    std::fseek(file, 0, SEEK_END);
+    if (std::ftell(file) == 0) {
+        std::fwrite(JOURNAL_MAGIC, 1, sizeof(JOURNAL_MAGIC), file);
+    }
+    JournalRecord session{JournalRecordType::SESSION};
+    session.timestamp = std::time(nullptr);
+    writeRecord(session);
+    for (SymbolId id = 0; id < symbols.size(); ++id) {
+        JournalRecord symbol{JournalRecordType::SYMBOL};
+        symbol.symbol = id;
+        symbol.quantity = static_cast<int32_t>(symbols[id].size());
+        writeRecord(symbol, symbols[id]);
+    }
+    syncFile(file);
+    writer = std::thread(&Journal::run, this);
+    return true;
+}
+
+void Journal::append(const JournalRecord& record) {
+    queue.push(record);
+}
+
+void Journal::close() {
+    if (writer.joinable()) {
+        queue.push(JournalRecord{JournalRecordType::STOP});
+        writer.join();
+    }
+    if (file) {
+        std::fclose(file);
+        file = nullptr;
+    }
+}
+
+void Journal::writeRecord(JournalRecord record, const std::string& name) {
+    record.checksum = recordChecksum(record, name);
+    std::fwrite(&record, sizeof(record), 1, file);
+    if (!name.empty()) {
+        std::fwrite(name.data(), 1, name.size(), file);
+    }
+}
+
+// Writes a record, preceded by the names of any traders it refers to that
+// are not persisted yet. Names are looked up here, off the matching thread.
+void Journal::encode(const JournalRecord& record) {
+    TraderId highest = std::max(record.trader, record.type == JournalRecordType::FILL ? record.buyer : 0);
+    if (record.type == JournalRecordType::ORDER || record.type == JournalRecordType::CANCEL
+        || record.type == JournalRecordType::AMEND || record.type == JournalRecordType::FILL) {
+        for (; journaledTraders <= highest; ++journaledTraders) {
+            std::string name = traderBase->getName(journaledTraders);
+            JournalRecord trader{JournalRecordType::TRADER};
+            trader.trader = journaledTraders;
+            trader.quantity = static_cast<int32_t>(name.size());
+            writeRecord(trader, name);
+        }
+    }
+    writeRecord(record);
+}
+
+void Journal::run() {
+    using Clock = std::chrono::steady_clock;
+    size_t unsynced = 0;
+    Clock::time_point oldestUnsynced;
+    bool stopping = false;
+    JournalRecord record;
+    while (!stopping) {
+        bool drained = false;
+        while (queue.tryPop(record)) {
+            if (record.type == JournalRecordType::STOP) {
+                stopping = true;
+                break;
+            }
+            encode(record);
+            if (unsynced++ == 0) oldestUnsynced = Clock::now();
+            drained = true;
+        }
+        if (drained) {
+            std::fflush(file); // hand the batch to the OS right away
+        }
+        // group commit: one fsync for many records
+        if (unsynced > 0 && (stopping || unsynced >= groupCommitSize || Clock::now() - oldestUnsynced >= groupCommitDelay)) {
+            syncFile(file);
+            unsynced = 0;
+        }
+        if (!drained && !stopping) {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+}
+
+bool Journal::replay(const std::string& filename, TraderBase& traderBase, const std::vector<std::string>& symbols,
+                     const std::function<void(const JournalRecord&)>& apply) {
+    std::FILE* input = std::fopen(filename.c_str(), "rb");
+    if (!input) {
+        return false;
+    }
+    char magic[sizeof(JOURNAL_MAGIC)] = {};
+    size_t recordSize = sizeof(JournalRecord);
+    if (std::fread(magic, 1, sizeof(magic), input) == sizeof(magic) && std::memcmp(magic, JOURNAL_MAGIC_V1, sizeof(magic)) == 0) {
+        recordSize = RECORD_SIZE_V1;
+    } else if (std::memcmp(magic, JOURNAL_MAGIC, sizeof(magic)) != 0) {
+        std::cerr << "Not a journal file: " << filename << std::endl;
+        std::fclose(input);
+        return false;
+    }
+
+    // trader ids in the journal -> ids in this process
+    std::vector<TraderId> traderIds;
+    auto resolve = [&traderIds](uint32_t id) {
+        return id < traderIds.size() && traderIds[id] != UINT32_MAX ? traderIds[id] : id;
+    };
+    // symbol ids of the current session -> index in `symbols`, UINT32_MAX if unknown
+    std::vector<SymbolId> symbolIds;
+
+    JournalRecord record{}; // a first format record leaves the sequence number 0
+    std::string name;
+    long validBytes = std::ftell(input);
+    bool damaged = false;
+    while (std::fread(&record, recordSize, 1, input) == 1) {
+        name.clear();
+        if (record.type == JournalRecordType::TRADER || record.type == JournalRecordType::SYMBOL) {
+            if (record.quantity < 0 || record.quantity > 4096) {
+                damaged = true;
+                break;
+            }
+            name.resize(record.quantity);
+            if (std::fread(name.data(), 1, name.size(), input) != name.size()) break;
+        }
+        if (recordChecksum(record, name, recordSize) != record.checksum) {
+            damaged = true;
+            break;
+        }
+        validBytes = std::ftell(input);
+
+        switch (record.type) {
+            case JournalRecordType::SESSION:
+                traderIds.clear();
+                symbolIds.clear();
+                break;
+            case JournalRecordType::TRADER:
+                if (traderIds.size() <= record.trader) traderIds.resize(record.trader + 1, UINT32_MAX);
+                traderIds[record.trader] = traderBase.addTrader(name);
+                break;
+            case JournalRecordType::SYMBOL: {
+                if (symbolIds.size() <= record.symbol) symbolIds.resize(record.symbol + 1, UINT32_MAX);
+                auto known = std::find(symbols.begin(), symbols.end(), name);
+                if (known == symbols.end()) {
+                    std::cerr << "Journal " << filename << " has orders of unknown symbol " << name << "; skipping them" << std::endl;
+                } else {
+                    symbolIds[record.symbol] = static_cast<SymbolId>(known - symbols.begin());
+                }
+                break;
+            }
+            case JournalRecordType::ORDER:
+            case JournalRecordType::CANCEL:
+            case JournalRecordType::AMEND:
+                if (symbolIds.empty()) {
+                    // journals written before symbols existed hold a single book
+                    if (symbols.empty()) break;
+                    record.symbol = 0;
+                } else if (record.symbol >= symbolIds.size() || symbolIds[record.symbol] == UINT32_MAX) {
+                    break;
+                } else {
+                    record.symbol = symbolIds[record.symbol];
+                }
+                record.trader = resolve(record.trader);
+                apply(record);
+                break;
+            default:
+                break;
+        }
+    }
+    damaged = damaged || !std::feof(input) || std::ftell(input) != validBytes;
+    std::fclose(input);
+
+    // a crash can leave a partially written tail; cut it off so that
+    // records appended from now on follow the last intact one
+    if (damaged) {
+        std::cerr << "Journal " << filename << " ends with a damaged record; truncating it" << std::endl;
+        std::error_code error;
+        std::filesystem::resize_file(filename, validBytes, error);
+    }
+    return true;
+}
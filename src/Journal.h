@@ -0,0 +1,93 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include "CommandType.h"
+#include "SpscQueue.h"
+
+enum class JournalRecordType : uint8_t {
+    SESSION = 1,    // written whenever the journal is opened, followed by the symbols
+    TRADER,         // trader id -> name; the name follows the record
+    ORDER,          // accepted buy / sell order
+    CANCEL,
+    AMEND,
+    FILL,           // informational: fills are re-derived by replaying orders
+    SYMBOL,         // symbol id -> name; the name follows the record
+    STOP            // internal: tells the writer thread to finish, never written
+};
+
+// Fixed-size binary journal record
+struct JournalRecord {
+    JournalRecordType type;
+    uint8_t side = 0;        // CommandType of an order
+    uint8_t orderType = 0;   // OrderType of an order
+    uint8_t selfTrade = 0;   // SelfTradePrevention of an order
+    int32_t quantity = 0;    // name length for TRADER and SYMBOL records
+    uint32_t trader = 0;     // order owner, seller of a fill, or registered trader
+    uint32_t buyer = 0;      // buyer of a fill
+    uint64_t orderId = 0;    // order id; aggressing order of a fill
+    int64_t pricePerOne = 0; // in ticks
+    int64_t timestamp = 0;
+    uint32_t checksum = 0;   // over the record (and the name of TRADER and SYMBOL records)
+    uint32_t symbol = 0;     // instrument of an order, cancel, amend or fill
+    uint64_t sequence = 0;   // of an order, cancel or amend within its symbol, from 1
+};
+static_assert(sizeof(JournalRecord) == 56, "journal record layout changed");
+
+JournalRecord makeCommandRecord(const Command& command, time_t timestamp);
+Command commandFromRecord(const JournalRecord& record);
+
+// Append-only binary write-ahead journal. The matching thread hands records
+// to append(), which only pushes them onto an SPSC ring; a dedicated writer
+// thread encodes them, writes them out as soon as it drains the ring, and
+// fsyncs once per group of `groupCommitSize` records or after
+// `groupCommitDelay`, whichever comes first.
+class Journal {
+public:
+    Journal() = default;
+    ~Journal();
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    void setGroupCommit(size_t maxRecords, std::chrono::microseconds maxDelay);
+
+    // Open the journal for appending and start the writer thread. Every
+    // session starts with the engine's symbol list; names of traders are
+    // looked up in `traderBase` and written ahead of the first record that
+    // refers to them.
+    bool open(const std::string& filename, const TraderBase& traderBase, const std::vector<std::string>& symbols, bool truncate);
+    // matching thread only; never blocks on I/O
+    void append(const JournalRecord& record);
+    // write and fsync everything appended so far, then stop the writer thread
+    void close();
+
+    // Read a journal back, registering its traders and passing every order,
+    // cancel and amend to `apply` in order, with trader ids resolved and
+    // symbols mapped to their index in `symbols`; records of symbols not in
+    // the list are skipped. Records of the first journal format have no
+    // sequence number and are passed on with 0. Returns false if the file is missing or not a
+    // journal; a torn or corrupt tail ends the replay and is cut off the file.
+    static bool replay(const std::string& filename, TraderBase& traderBase, const std::vector<std::string>& symbols,
+                       const std::function<void(const JournalRecord&)>& apply);
+
+private:
+    void run();
+    void encode(const JournalRecord& record);
+    void writeRecord(JournalRecord record, const std::string& name = "");
+
+    SpscQueue<JournalRecord, 65536> queue{WaitStrategy::SPIN_YIELD};
+    std::thread writer;
+    std::FILE* file = nullptr;
+    const TraderBase* traderBase = nullptr;
+    TraderId journaledTraders = 0; // traders whose names this session has written
+    size_t groupCommitSize = 256;
+    std::chrono::microseconds groupCommitDelay{1000};
+};
+
+#endif // JOURNAL_H
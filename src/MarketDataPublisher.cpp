@@ -0,0 +1,93 @@
+#include "MarketDataPublisher.h"
+#include "Runtime.h"
+#include <algorithm>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+
+static TopOrder copyTop(const Order* order) {
+    if (!order) return TopOrder{};
+    return TopOrder{true, order->getQuantity(), order->getTrader(), order->getId(), order->getPricePerOne(), order->getDate()};
+}
+
+MarketDataPublisher::MarketDataPublisher(const TraderBase& traderBase) : traderBase(traderBase) {}
+
+MarketDataPublisher::~MarketDataPublisher() {
+    stop();
+}
+
+void MarketDataPublisher::setMaxRate(int updatesPerSecond) {
+    interval = std::chrono::microseconds(1000000 / std::max(updatesPerSecond, 1));
+}
+
+size_t MarketDataPublisher::addBook(const std::string& filename) {
+    books.push_back(std::make_unique<Book>());
+    books.back()->filename = filename;
+    books.back()->written = books.back()->topOfBook.getSequence(); // nothing published yet
+    return books.size() - 1;
+}
+
+void MarketDataPublisher::start() {
+    stop();
+    stopping.store(false, std::memory_order_relaxed);
+    publisher = std::thread(&MarketDataPublisher::run, this);
+}
+
+bool MarketDataPublisher::pin(unsigned cpu) {
+    return publisher.joinable() && pinThread(publisher, cpu);
+}
+
+void MarketDataPublisher::stop() {
+    if (publisher.joinable()) {
+        stopping.store(true, std::memory_order_release);
+        publisher.join();
+    }
+}
+
+void MarketDataPublisher::publish(size_t book, const Order* topBuyOrder, const Order* topSellOrder) {
+    books[book]->topOfBook.store(TopOfBook{copyTop(topBuyOrder), copyTop(topSellOrder), steadyNanoseconds()});
+}
+
+void MarketDataPublisher::run() {
+    while (true) {
+        bool last = stopping.load(std::memory_order_acquire);
+        for (auto& book : books) {
+            if (book->topOfBook.getSequence() != book->written) {
+                TopOfBook top;
+                book->written = book->topOfBook.load(top);
+                write(*book, top);
+                publishLatency.record(steadyNanoseconds() - top.publishedAt);
+            }
+        }
+        if (last) break;
+        std::this_thread::sleep_for(interval);
+    }
+}
+
+// Human-readable order description for the top orders file
+std::string MarketDataPublisher::describe(const TopOrder& order, const char* none) const {
+    if (!order.present) return none;
+    return std::format("{} {} {} {} {}", order.id, order.quantity, formatPrice(order.pricePerOne), order.date, traderBase.getName(order.trader));
+}
+
+// Update top orders via writing a new file and renaming it over the old one,
+// so readers never see a partially written file
+void MarketDataPublisher::write(const Book& book, const TopOfBook& top) {
+    const std::string& filename = book.filename;
+    std::string temporaryFile = filename + ".tmp";
+    std::ofstream file(temporaryFile, std::ios::trunc);
+    if (file.is_open()) {
+        file << "Top Buy Order: " << describe(top.buy, "No Buy Orders") << '\n';
+        file << "Top Sell Order: " << describe(top.sell, "No Sell Orders") << '\n';
+        file.close();
+        std::error_code error;
+        std::filesystem::rename(temporaryFile, filename, error);
+        if (error) {
+            std::cerr << "Error writing a file: " << filename << std::endl;
+        }
+    }
+    else{
+        std::cerr << "Error opening a file: " << temporaryFile << std::endl;
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef MARKETDATAPUBLISHER_H
+#define MARKETDATAPUBLISHER_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Order.h"
+#include "Seqlock.h"
+#include "Stats.h"
+
+// best resting order of one side, copied out of the book
+struct TopOrder {
+    bool present = false;
+    int quantity = 0;
+    TraderId trader = 0;
+    OrderId id = 0;
+    Price pricePerOne = 0;
+    time_t date = 0;
+};
+
+struct TopOfBook {
+    TopOrder buy;
+    TopOrder sell;
+    int64_t publishedAt = 0; // steadyNanoseconds() when the matching thread published it
+};
+
+// Publishes the top of each book to its own file from one long-lived
+// thread. The matching thread owning a book only stores its current top
+// into the book's seqlock; the publisher thread picks up the latest values
+// at most `maxRate` times per second, so intermediate updates are
+// conflated, and replaces each file atomically by writing a temporary file
+// and renaming it.
+class MarketDataPublisher {
+public:
+    explicit MarketDataPublisher(const TraderBase& traderBase);
+    ~MarketDataPublisher();
+    MarketDataPublisher(const MarketDataPublisher&) = delete;
+    MarketDataPublisher& operator=(const MarketDataPublisher&) = delete;
+
+    // only valid while the publisher is not running
+    void setMaxRate(int updatesPerSecond);
+    // register a book published to `filename`; returns its index
+    size_t addBook(const std::string& filename);
+
+    void start();
+    // pin the running publisher thread to `cpu`
+    bool pin(unsigned cpu);
+    // write the latest top of every book if it is not written yet, then stop
+    void stop();
+
+    // the thread matching `book` only; never blocks
+    void publish(size_t book, const Order* topBuyOrder, const Order* topSellOrder);
+
+    // time from publish() until the file holding that top was replaced;
+    // readable from any thread
+    const LatencyHistogram& getPublishLatency() const { return publishLatency; }
+
+private:
+    struct Book {
+        Seqlock<TopOfBook> topOfBook;
+        std::string filename;
+        uint64_t written = 0; // sequence of the last value written, publisher thread only
+    };
+
+    void run();
+    void write(const Book& book, const TopOfBook& top);
+    std::string describe(const TopOrder& order, const char* none) const;
+
+    const TraderBase& traderBase;
+    std::vector<std::unique_ptr<Book>> books;
+    std::chrono::microseconds interval{50000};
+    LatencyHistogram publishLatency; // publisher thread only
+    std::atomic<bool> stopping{false};
+    std::thread publisher;
+};
+
+#endif // MARKETDATAPUBLISHER_H
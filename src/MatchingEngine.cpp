@@ -0,0 +1,160 @@
+#include "MatchingEngine.h"
+#include <limits>
+
+MatchingEngine::MatchingEngine(OrderBook& orderBook, TransactionList& txList, TradeAnalytics* analytics, RiskTable* risk)
+    : orderBook(orderBook), txList(txList), analytics(analytics), risk(risk) {}
+
+SubmitResult MatchingEngine::submit(const Command& command, time_t timestamp, Journal* journal, bool checkLimits) {
+    fills.clear();
+    CommandStatus status = execute(command, command.timestamp ? command.timestamp : timestamp, journal, checkLimits);
+    txList.publishTransactions();
+    return {status, fills};
+}
+
+std::span<const Transaction> MatchingEngine::submitMany(std::span<const Command> commands, time_t timestamp,
+                                                        std::span<CommandStatus> statuses, Journal* journal,
+                                                        bool checkLimits) {
+    fills.clear();
+    for (size_t i = 0; i < commands.size(); ++i) {
+        statuses[i] = execute(commands[i], commands[i].timestamp ? commands[i].timestamp : timestamp, journal, checkLimits);
+    }
+    txList.publishTransactions();
+    return fills;
+}
+
+CommandStatus MatchingEngine::execute(const Command& command, time_t timestamp, Journal* journal, bool checkLimits) {
+    if (command.type == CommandType::CANCEL || command.type == CommandType::AMEND) {
+        const Order* order = orderBook.findOrder(command.orderId);
+        if (order && order->getTrader() != command.trader) {
+            return CommandStatus::NOT_ORDER_OWNER;
+        }
+    }
+    if (risk && checkLimits && !withinLimits(command)) {
+        return CommandStatus::RISK_LIMIT_EXCEEDED;
+    }
+    if (journal) {
+        JournalRecord record = makeCommandRecord(command, timestamp);
+        record.sequence = ++journalSequence;
+        journal->append(record);
+    }
+    if (risk && (command.type == CommandType::CANCEL || command.type == CommandType::AMEND)) {
+        return changeOrder(command);
+    }
+    switch (command.type) {
+        case CommandType::CANCEL:
+            return orderBook.cancelOrder(command.orderId) ? CommandStatus::DONE : CommandStatus::ORDER_NOT_FOUND;
+        case CommandType::AMEND:
+            return orderBook.amendOrder(command.orderId, command.quantity) ? CommandStatus::DONE : CommandStatus::ORDER_NOT_FOUND;
+        default:
+            return processOrder(command, timestamp, journal);
+    }
+}
+
+// Whether a new order, or an amend to a larger quantity, stays within the
+// risk limits; cancels, and amends of orders not resting, always pass.
+bool MatchingEngine::withinLimits(const Command& command) const {
+    if (command.type == CommandType::CANCEL) {
+        return true;
+    }
+    if (command.type == CommandType::AMEND) {
+        const Order* order = orderBook.findOrder(command.orderId);
+        int increase = order ? command.quantity - order->getQuantity() : 0;
+        return increase <= 0 || risk->allows(order->getTrader(), order->isBuy(), increase, order->getPricePerOne());
+    }
+    bool isMarket = command.orderType == OrderType::MARKET;
+    return risk->allows(command.trader, command.type == CommandType::BUY, command.quantity, isMarket ? 0 : command.pricePerOne);
+}
+
+// Cancel or amend an order, keeping the risk table up to date.
+CommandStatus MatchingEngine::changeOrder(const Command& command) {
+    const Order* order = orderBook.findOrder(command.orderId);
+    if (!order) return CommandStatus::ORDER_NOT_FOUND;
+    TraderId trader = order->getTrader();
+    bool isBuy = order->isBuy();
+    Price price = order->getPricePerOne();
+    int quantity = order->getQuantity();
+    if (command.type == CommandType::CANCEL) {
+        orderBook.cancelOrder(command.orderId);
+        risk->orderRemoved(trader, isBuy, quantity, price);
+        return CommandStatus::DONE;
+    }
+    int increase = command.quantity - quantity;
+    if (!orderBook.amendOrder(command.orderId, command.quantity)) return CommandStatus::ORDER_NOT_FOUND;
+    risk->orderAdded(trader, isBuy, increase, price);
+    return CommandStatus::DONE;
+}
+
+// Match a new buy or sell order and rest whatever is left of it,
+// according to its order type. Fills are journaled when `journal` is set.
+CommandStatus MatchingEngine::processOrder(const Command& command, time_t timestamp, Journal* journal) {
+    bool isBuy = command.type == CommandType::BUY;
+    bool isMarket = command.orderType == OrderType::MARKET;
+    // a market order accepts any price on the opposite side
+    Price limit = !isMarket ? command.pricePerOne
+                : isBuy ? std::numeric_limits<Price>::max() : std::numeric_limits<Price>::min();
+
+    if (command.orderType == OrderType::POST_ONLY
+        && (isBuy ? orderBook.buyWouldCross(limit) : orderBook.sellWouldCross(limit))) {
+        return CommandStatus::POST_ONLY_WOULD_MATCH;
+    }
+    if (command.orderType == OrderType::FOK
+        && (isBuy ? orderBook.getFillableBuyQuantity(command.trader, limit, command.quantity, command.selfTrade)
+                  : orderBook.getFillableSellQuantity(command.trader, limit, command.quantity, command.selfTrade)) < command.quantity) {
+        return CommandStatus::NOT_ENOUGH_QUANTITY;
+    }
+    // only limit and post-only orders rest their unfilled quantity
+    bool rests = command.orderType == OrderType::LIMIT || command.orderType == OrderType::POST_ONLY;
+
+    // resting quantity leaving the book, by a fill or self-trade prevention
+    auto removeResting = [&](const Order& resting, int quantity) {
+        if (risk) risk->orderRemoved(resting.getTrader(), resting.isBuy(), quantity, resting.getPricePerOne());
+    };
+    auto addFill = [&](const Order& resting, int fillQuantity, Price price, TraderId seller, TraderId buyer) {
+        if (journal) {
+            JournalRecord fill{JournalRecordType::FILL};
+            fill.quantity = fillQuantity;
+            fill.trader = seller;
+            fill.buyer = buyer;
+            fill.orderId = command.orderId;
+            fill.pricePerOne = price;
+            fill.timestamp = timestamp;
+            fill.symbol = command.symbol;
+            journal->append(fill);
+        }
+        Transaction tx(fillQuantity, price, timestamp, seller, buyer);
+        fills.push_back(tx);
+        txList.appendTransaction(tx);
+        if (analytics) analytics->addFill(tx);
+        if (risk) risk->filled(buyer, seller, fillQuantity);
+        removeResting(resting, fillQuantity);
+    };
+
+    // match the incoming order against the opposite side first;
+    // only the unfilled remainder is added to the order book. The fills
+    // are appended as they happen and published by the caller.
+    MatchResult result;
+    if (isBuy) {
+        result = orderBook.matchBuyOrder(command.trader, limit, command.quantity, command.selfTrade,
+            [&](const Order& sellOrder, int fillQuantity) {
+                addFill(sellOrder, fillQuantity, sellOrder.getPricePerOne(), sellOrder.getTrader(), command.trader);
+            }, removeResting);
+    } else {
+        // fills are priced at the sell order's price, as before;
+        // a market sell order has none, so it takes the buy order's price
+        result = orderBook.matchSellOrder(command.trader, limit, command.quantity, command.selfTrade,
+            [&](const Order& buyOrder, int fillQuantity) {
+                Price price = isMarket ? buyOrder.getPricePerOne() : command.pricePerOne;
+                addFill(buyOrder, fillQuantity, price, command.trader, buyOrder.getTrader());
+            }, removeResting);
+    }
+    if (result.remaining > 0 && rests && !result.selfTrade) {
+        OrderPtr order = orderBook.createOrder(command.orderId, result.remaining, command.pricePerOne, timestamp, command.trader);
+        if (isBuy) {
+            orderBook.addBuyOrder(std::move(order));
+        } else {
+            orderBook.addSellOrder(std::move(order));
+        }
+        if (risk) risk->orderAdded(command.trader, isBuy, result.remaining, command.pricePerOne);
+    }
+    return result.selfTrade ? CommandStatus::SELF_TRADE_CANCELLED : CommandStatus::DONE;
+}
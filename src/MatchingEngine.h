@@ -0,0 +1,82 @@
+#ifndef MATCHINGENGINE_H
+#define MATCHINGENGINE_H
+
+#include <ctime>
+#include <span>
+#include <vector>
+#include "CommandType.h"
+#include "Journal.h"
+#include "OrderBook.h"
+#include "RiskTable.h"
+#include "TradeAnalytics.h"
+#include "TransactionList.h"
+
+// outcome of applying a command to the order book
+enum class CommandStatus {
+    DONE,
+    ORDER_NOT_FOUND,       // cancel / amend of an order that is not resting
+    NOT_ORDER_OWNER,       // cancel / amend by a trader other than the order's
+    POST_ONLY_WOULD_MATCH, // post-only order rejected
+    NOT_ENOUGH_QUANTITY,   // fill-or-kill order killed
+    SELF_TRADE_CANCELLED,  // rest of the order cancelled by self-trade prevention
+    RISK_LIMIT_EXCEEDED    // order or amend rejected by the pre-trade risk check
+};
+
+struct SubmitResult {
+    CommandStatus status = CommandStatus::DONE;
+    std::span<const Transaction> fills; // valid until the next submit
+};
+
+// Price-time matching of one symbol's commands against its order book.
+// Fills go to the transaction list, which readers see once per submit
+// (or once per batch), and to the analytics if there are any, and are
+// also handed back to the caller. With a risk table, every new order and
+// every amend to a larger quantity is checked against the limits first. The
+// engine, the journal recovery, the tests and the benchmarks all match
+// through this class. Matching thread of the symbol only.
+class MatchingEngine {
+public:
+    MatchingEngine(OrderBook& orderBook, TransactionList& txList, TradeAnalytics* analytics = nullptr,
+                   RiskTable* risk = nullptr);
+    MatchingEngine(const MatchingEngine&) = delete;
+    MatchingEngine& operator=(const MatchingEngine&) = delete;
+
+    // Apply a buy, sell, cancel or amend command at its own timestamp, or at
+    // `timestamp` if it has none. With a journal the command and its fills
+    // are logged first; the journal only queues them, so no I/O happens
+    // here. Cancels and amends must come from the trader owning the order.
+    // A command rejected by that or by the risk check changes nothing and
+    // is not logged. Replaying the journal calls this without one and with
+    // `checkLimits` off: the commands were accepted when logged, under
+    // limits that may have changed since, and only the counters are updated.
+    SubmitResult submit(const Command& command, time_t timestamp, Journal* journal = nullptr, bool checkLimits = true);
+
+    // Apply commands in order, each at its own timestamp or at `timestamp`
+    // if it has none, and publish all their fills at once. statuses[i] is
+    // set for commands[i]; returns the fills of the whole batch, valid until
+    // the next submit.
+    std::span<const Transaction> submitMany(std::span<const Command> commands, time_t timestamp,
+                                            std::span<CommandStatus> statuses, Journal* journal = nullptr,
+                                            bool checkLimits = true);
+
+    // sequence number of the last command journaled; every journaled
+    // command gets the next one, so a snapshot taken with this number
+    // covers exactly the records up to it
+    uint64_t getJournalSequence() const { return journalSequence; }
+    void setJournalSequence(uint64_t sequence) { journalSequence = sequence; }
+
+private:
+    CommandStatus execute(const Command& command, time_t timestamp, Journal* journal, bool checkLimits);
+    bool withinLimits(const Command& command) const;
+    CommandStatus processOrder(const Command& command, time_t timestamp, Journal* journal);
+    CommandStatus changeOrder(const Command& command);
+
+    OrderBook& orderBook;
+    TransactionList& txList;
+    TradeAnalytics* analytics;
+    RiskTable* risk;
+    std::vector<Transaction> fills; // of the current submit, reused
+    uint64_t journalSequence = 0;
+};
+
+#endif // MATCHINGENGINE_H
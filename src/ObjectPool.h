@@ -0,0 +1,108 @@
+#ifndef OBJECTPOOL_H
+#define OBJECTPOOL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+#include "Runtime.h"
+
+template <typename T>
+class ObjectPool;
+
+// returns an object to the pool it came from instead of freeing it
+template <typename T>
+struct PoolDeleter {
+    ObjectPool<T>* pool = nullptr;
+    void operator()(T* object) const { pool->release(object); }
+};
+
+template <typename T>
+using PoolPtr = std::unique_ptr<T, PoolDeleter<T>>;
+
+struct PoolStats {
+    size_t slabs = 0;       // slabs requested from the system allocator
+    size_t capacity = 0;    // slots across all slabs
+    size_t allocations = 0; // objects handed out in total
+    size_t releases = 0;    // objects returned to the pool in total
+    size_t live = 0;        // objects currently handed out
+};
+
+// Slab allocator for objects of a single type. Memory is requested in
+// slabs of `slabSize` slots and freed slots are kept on an intrusive free
+// list, so once the pool has grown to its working size no further
+// allocations happen. Not thread safe: a pool belongs to one thread.
+template <typename T>
+class ObjectPool {
+public:
+    explicit ObjectPool(size_t slabSize = 4096) : slabSize(slabSize) {}
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    template <typename... Args>
+    PoolPtr<T> make(Args&&... args) {
+        if (!freeList) {
+            addSlab();
+        }
+        Slot* slot = freeList;
+        freeList = slot->next;
+        T* object = new (slot->storage) T(std::forward<Args>(args)...);
+        ++stats.allocations;
+        ++stats.live;
+        return PoolPtr<T>(object, PoolDeleter<T>{this});
+    }
+
+    void release(T* object) {
+        if (!object) return;
+        object->~T();
+        Slot* slot = reinterpret_cast<Slot*>(object);
+        slot->next = freeList;
+        freeList = slot;
+        ++stats.releases;
+        --stats.live;
+    }
+
+    // grow the pool up front so that `count` more objects fit without new
+    // slabs; a large reservation is satisfied by a single slab
+    void reserve(size_t count) {
+        size_t available = stats.capacity - stats.live;
+        if (available < count) {
+            addSlab(std::max(slabSize, count - available));
+        }
+    }
+
+    const PoolStats& getStats() const { return stats; }
+
+private:
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    void addSlab() { addSlab(slabSize); }
+
+    // a slab is written in full right away to link its free list, so a
+    // large one gets huge pages before that, if the system has them
+    void addSlab(size_t size) {
+        auto slab = std::make_unique_for_overwrite<Slot[]>(size);
+        if (size * sizeof(Slot) >= HUGE_PAGE_SIZE) {
+            adviseHugePages(slab.get(), size * sizeof(Slot));
+        }
+        for (size_t i = 0; i < size; ++i) {
+            slab[i].next = i + 1 < size ? &slab[i + 1] : freeList;
+        }
+        freeList = &slab[0];
+        slabs.push_back(std::move(slab));
+        ++stats.slabs;
+        stats.capacity += size;
+    }
+
+    std::vector<std::unique_ptr<Slot[]>> slabs;
+    Slot* freeList = nullptr;
+    size_t slabSize;
+    PoolStats stats;
+};
+
+#endif // OBJECTPOOL_H
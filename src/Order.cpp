@@ -1,38 +1,57 @@
 #include "Order.h"
-#include <sstream>
+#include "Tokenizer.h"
 #include <format>
 
-Order::Order(int quantity, double totalPrice, time_t timestamp, const std::string& trader)
-    : quantity(quantity), pricePerOne(totalPrice / quantity), date(timestamp), trader(trader) {}
+Order::Order(OrderId id, int quantity, Price pricePerOne, time_t timestamp, TraderId trader)
+    : id(id), quantity(quantity), pricePerOne(pricePerOne), date(timestamp), trader(trader) {}
+    // - `id`: The engine-assigned order id.
     // - `quantity`: The number of items in the order.
-    // - `totalPrice / quantity`: Sets the price per item.
+    // - `pricePerOne`: The price per item, in ticks.
     // - `date`: The timestamp for when the order was created.
-    // - `trader`: The username of a trader who placed the order.
+    // - `trader`: The id of the trader who placed the order.
 
-// serialize order for file writing
-std::string Order::serialize() const {
-    return std::format("{} {} {} {}", quantity, pricePerOne, date, trader);
+// serialize order for file writing (price in ticks, trader by name)
+std::string Order::serialize(const TraderBase& traderBase) const {
+    return std::format("{} {} {} {} {}", id, quantity, pricePerOne, date, traderBase.getName(trader));
 }
 
 // deserialize order received from a file
-std::unique_ptr<Order> Order::deserialize(const std::string& data) {
-    std::stringstream ss(data);
+OrderPtr Order::deserialize(std::string_view data, ObjectPool<Order>& pool, TraderBase& traderBase) {
+    Tokenizer tokens(data);
+    OrderId id;
     int quantity;
-    double pricePerOne;
+    Price pricePerOne;
     time_t date;
-    std::string trader;
-    if (ss >> quantity >> pricePerOne >> date >> trader) {
-        return std::make_unique<Order>(quantity, pricePerOne * quantity, date, trader);
+    std::string_view trader;
+    if (nextNumber(tokens, id) && nextNumber(tokens, quantity) && nextNumber(tokens, pricePerOne)
+        && nextNumber(tokens, date) && tokens.next(trader) && quantity > 0 && pricePerOne > 0) {
+        return pool.make(id, quantity, pricePerOne, date, traderBase.addTrader(trader));
+    }
+    // Return nullptr if deserialization fails or the order could not rest
+    return nullptr;
+}
+
+OrderPtr Order::deserializeDecimal(std::string_view data, OrderId id, ObjectPool<Order>& pool, TraderBase& traderBase) {
+    Tokenizer tokens(data);
+    int quantity;
+    std::string_view priceText;
+    Price pricePerOne;
+    time_t date;
+    std::string_view trader;
+    if (nextNumber(tokens, quantity) && tokens.next(priceText) && decimalPriceToTicks(priceText, pricePerOne)
+        && nextNumber(tokens, date) && tokens.next(trader) && quantity > 0 && pricePerOne > 0) {
+        return pool.make(id, quantity, pricePerOne, date, traderBase.addTrader(trader));
     }
-    // Return nullptr if deserialization fails
     return nullptr;
 }
 
 // getter functions for private attributes
-double Order::getPricePerOne() const { return pricePerOne; }
+OrderId Order::getId() const { return id; }
+Price Order::getPricePerOne() const { return pricePerOne; }
 time_t Order::getDate() const { return date; }
 int Order::getQuantity() const { return quantity; }
-std::string Order::getTrader() const { return trader; }
+TraderId Order::getTrader() const { return trader; }
+bool Order::isBuy() const { return buy; }
 
 // modify the quantity (used when order matched)
 void Order::changeQuantity(int change) { quantity -= change; }
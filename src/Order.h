@@ -3,23 +3,48 @@
 
 #include <string>
 #include <memory>
+#include "Price.h"
+#include "ObjectPool.h"
+#include "TraderBase.h"
+
+class Order;
+struct PriceLevel;
+using OrderPtr = PoolPtr<Order>;
+
+// engine-assigned, unique order identifier
+using OrderId = uint64_t;
 
 class Order {
 public:
-    Order(int quantity, double totalPrice, time_t timestamp, const std::string& trader);
-    std::string serialize() const;
-    static std::unique_ptr<Order> deserialize(const std::string& data);
-    double getPricePerOne() const;
+    Order(OrderId id, int quantity, Price pricePerOne, time_t timestamp, TraderId trader);
+    std::string serialize(const TraderBase& traderBase) const;
+    static OrderPtr deserialize(std::string_view data, ObjectPool<Order>& pool, TraderBase& traderBase);
+    // an order of the first text format, which has a decimal price and no id
+    static OrderPtr deserializeDecimal(std::string_view data, OrderId id, ObjectPool<Order>& pool, TraderBase& traderBase);
+    OrderId getId() const;
+    Price getPricePerOne() const;
     time_t getDate() const;
     int getQuantity() const;
     void changeQuantity(int change);
-    std::string getTrader() const;
+    TraderId getTrader() const;
+    // side of the book the order rests on
+    bool isBuy() const;
 
 private:
+    OrderId id;
     int quantity;
-    double pricePerOne;
+    Price pricePerOne;
     time_t date;
-    std::string trader;
+    TraderId trader;
+    bool buy = false; // set when the order is added to the book
+
+    // position in the book: the price level queue holding the order
+    // and its neighbours in that queue
+    friend struct PriceLevel;
+    friend class OrderBook;
+    PriceLevel* level = nullptr;
+    Order* prev = nullptr;
+    Order* next = nullptr;
 };
 
 #endif // ORDER_H
\ No newline at end of file
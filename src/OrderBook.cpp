@@ -1,81 +1,264 @@
 #include "OrderBook.h"
+#include "Tokenizer.h"
 #include <iostream>
 #include <fstream>
-#include <sstream>
-#include <algorithm>
 #include <format>
 
-// orders with higher price have priority; 
-// if prices are equal, earlier orders are prioritized.
-struct greaterBuy{
-    bool operator()(const std::unique_ptr<Order>& a,const std::unique_ptr<Order>& b) const{
-        if(a->getPricePerOne() == b->getPricePerOne()){
-            return a->getDate() > b->getDate();
-        }
-        return a->getPricePerOne() < b->getPricePerOne();
+void PriceLevel::pushBack(Order* order) {
+    order->prev = tail;
+    order->next = nullptr;
+    if (tail) {
+        tail->next = order;
+    } else {
+        head = order;
+    }
+    tail = order;
+    quantity += order->getQuantity();
+    ++orderCount;
+}
+
+Order* PriceLevel::popFront() {
+    Order* order = head;
+    remove(order);
+    return order;
+}
+
+void PriceLevel::remove(Order* order) {
+    if (order->prev) {
+        order->prev->next = order->next;
+    } else {
+        head = order->next;
+    }
+    if (order->next) {
+        order->next->prev = order->prev;
+    } else {
+        tail = order->prev;
+    }
+    order->prev = nullptr;
+    order->next = nullptr;
+    quantity -= order->getQuantity();
+    --orderCount;
+}
+
+void PriceLevel::relink() {
+    for (Order* order = head; order; order = order->next) {
+        order->level = this;
     }
-};
-
-// orders with lower price have priority; 
-// if prices are equal, earlier orders are prioritized.
-struct greaterSell{
-    bool operator()(const std::unique_ptr<Order>& a,const std::unique_ptr<Order>& b) const{
-        if(a->getPricePerOne() == b->getPricePerOne()){
-            return a->getDate() > b->getDate();
+}
+
+// orders are grouped into price levels; within a level, earlier orders
+// are prioritized simply by their position in the FIFO queue.
+template <typename Levels>
+void OrderBook::pushOrder(Levels& levels, OrderPtr newOrder) {
+    Order* order = newOrder.release();
+    PriceLevel& level = levels[order->getPricePerOne()];
+    level.pushBack(order);
+    order->level = &level;
+    orderIndex[order->getId()] = order;
+    lastOrderId = std::max(lastOrderId, order->getId());
+}
+
+template <typename Levels>
+void OrderBook::popOrder(Levels& levels) {
+    Price price;
+    PriceLevel* level = levels.best(price);
+    if (level) {
+        removeFront(levels, price, *level);
+    }
+}
+
+template <typename Levels>
+void OrderBook::releaseAll(Levels& levels) {
+    Price price;
+    while (PriceLevel* level = levels.best(price)) {
+        while (level->head) {
+            orderPool.release(level->popFront());
         }
-        return a->getPricePerOne() > b->getPricePerOne();
+        levels.erase(price);
+    }
+}
+
+template <typename Levels>
+size_t OrderBook::copyDepth(const Levels& levels, DepthLevel* depth, size_t count) {
+    size_t copied = 0;
+    for (const auto& [price, level] : levels) {
+        if (copied == count) break;
+        depth[copied++] = DepthLevel{price, level.quantity, level.orderCount};
     }
-};
+    return copied;
+}
 
-OrderBook::OrderBook() {
-    std::make_heap(sellOrders.begin(), sellOrders.end(), greaterSell());
-    std::make_heap(buyOrders.begin(), buyOrders.end(), greaterBuy());
+// drop an order that has left its level from the index and recycle its slot
+void OrderBook::releaseOrder(Order* order) {
+    orderIndex.erase(order->getId());
+    orderPool.release(order);
+}
+
+OrderBook::OrderBook() : sellLevels(&levelResource), buyLevels(&levelResource), orderIndex(&levelResource) {}
+
+OrderBook::~OrderBook() {
+    releaseAll(sellLevels);
+    releaseAll(buyLevels);
+}
+
+OrderPtr OrderBook::createOrder(OrderId id, int quantity, Price pricePerOne, time_t timestamp, TraderId trader) {
+    return orderPool.make(id, quantity, pricePerOne, timestamp, trader);
 }
 
 // push orders
-void OrderBook::addSellOrder(std::unique_ptr<Order> newOrder) {
-    sellOrders.push_back(std::move(newOrder));
-    std::push_heap(sellOrders.begin(), sellOrders.end(), greaterSell());
+void OrderBook::addSellOrder(OrderPtr newOrder) {
+    newOrder->buy = false;
+    pushOrder(sellLevels, std::move(newOrder));
 }
 
-void OrderBook::addBuyOrder(std::unique_ptr<Order> newOrder) {
-    buyOrders.push_back(std::move(newOrder));
-    std::push_heap(buyOrders.begin(), buyOrders.end(), greaterBuy());
+void OrderBook::addBuyOrder(OrderPtr newOrder) {
+    newOrder->buy = true;
+    pushOrder(buyLevels, std::move(newOrder));
 }
 
-// pop orders
+// pop orders; the freed slot goes back to the order pool
 void OrderBook::popSellOrder() {
-    if (!sellOrders.empty()) {
-        std::pop_heap(sellOrders.begin(), sellOrders.end(), greaterSell());
-        sellOrders.pop_back();
-    }
+    popOrder(sellLevels);
 }
 
 void OrderBook::popBuyOrder() {
-    if (!buyOrders.empty()) {
-        std::pop_heap(buyOrders.begin(), buyOrders.end(), greaterBuy());
-        buyOrders.pop_back();
-    }
+    popOrder(buyLevels);
 }
 
 // get front orders
 Order* OrderBook::getFrontSellOrder() {
-    return sellOrders.empty() ? nullptr : sellOrders.front().get();
+    Price price;
+    PriceLevel* level = sellLevels.best(price);
+    return level ? level->head : nullptr;
 }
 
 Order* OrderBook::getFrontBuyOrder() {
-    return buyOrders.empty() ? nullptr : buyOrders.front().get();
+    Price price;
+    PriceLevel* level = buyLevels.best(price);
+    return level ? level->head : nullptr;
 }
 
-void OrderBook::saveToFile(const std::string& filename) {
-    std::ofstream file(filename);
-    if(file.is_open()){
-        for (const auto& order : sellOrders) {
-            file << "sell " << order->serialize() << std::endl;
+Order* OrderBook::findOrder(OrderId id) const {
+    auto it = orderIndex.find(id);
+    return it == orderIndex.end() ? nullptr : it->second;
+}
+
+bool OrderBook::cancelOrder(OrderId id) {
+    Order* order = findOrder(id);
+    if (!order) return false;
+    PriceLevel* level = order->level;
+    Price price = order->getPricePerOne();
+    bool buy = order->isBuy();
+    level->remove(order);
+    releaseOrder(order);
+    if (!level->head) {
+        if (buy) {
+            buyLevels.erase(price);
+        } else {
+            sellLevels.erase(price);
         }
-        for (const auto& order : buyOrders) {
-            file << "buy " << order->serialize() << std::endl;
+    }
+    return true;
+}
+
+bool OrderBook::amendOrder(OrderId id, int quantity) {
+    Order* order = findOrder(id);
+    if (!order || quantity <= 0) return false;
+    int change = order->getQuantity() - quantity;
+    if (change < 0) {
+        // a larger order loses its place in the queue
+        order->level->remove(order);
+        order->level->pushBack(order);
+    }
+    order->changeQuantity(change);
+    order->level->quantity -= change;
+    return true;
+}
+
+OrderId OrderBook::getLastOrderId() const {
+    return lastOrderId;
+}
+
+// walk the levels a sweep would take, without touching them
+template <typename Levels, typename Crosses>
+int OrderBook::fillable(const Levels& levels, Crosses crosses, TraderId trader, int quantity, SelfTradePrevention selfTrade) const {
+    int total = 0;
+    for (const auto& [price, level] : levels) {
+        if (!crosses(price)) break;
+        for (const Order* order = level.head; order; order = order->next) {
+            if (order->getTrader() == trader) {
+                // a decremented order uses up the incoming quantity like a
+                // fill; a cancelled resting order lets the incoming one go
+                // on; the other policies stop the incoming order here
+                if (selfTrade == SelfTradePrevention::DECREMENT) {
+                    total += order->getQuantity();
+                    if (total >= quantity) return quantity;
+                    continue;
+                }
+                if (selfTrade != SelfTradePrevention::CANCEL_OLDEST) return total;
+                continue;
+            }
+            total += order->getQuantity();
+            if (total >= quantity) return quantity;
         }
+    }
+    return total;
+}
+
+int OrderBook::getFillableBuyQuantity(TraderId trader, Price limit, int quantity, SelfTradePrevention selfTrade) const {
+    return fillable(sellLevels, [limit](Price price) { return price <= limit; }, trader, quantity, selfTrade);
+}
+
+int OrderBook::getFillableSellQuantity(TraderId trader, Price limit, int quantity, SelfTradePrevention selfTrade) const {
+    return fillable(buyLevels, [limit](Price price) { return price >= limit; }, trader, quantity, selfTrade);
+}
+
+bool OrderBook::buyWouldCross(Price limit) const {
+    Price price;
+    return sellLevels.best(price) && price <= limit;
+}
+
+bool OrderBook::sellWouldCross(Price limit) const {
+    Price price;
+    return buyLevels.best(price) && price >= limit;
+}
+
+size_t OrderBook::getBuyDepth(DepthLevel* levels, size_t count) const {
+    return copyDepth(buyLevels, levels, count);
+}
+
+size_t OrderBook::getSellDepth(DepthLevel* levels, size_t count) const {
+    return copyDepth(sellLevels, levels, count);
+}
+
+void OrderBook::getDepth(BookDepth& depth) const {
+    depth.buyLevels = getBuyDepth(depth.buy, BookDepth::LEVELS);
+    depth.sellLevels = getSellDepth(depth.sell, BookDepth::LEVELS);
+}
+
+void OrderBook::reserve(size_t count) {
+    orderPool.reserve(count);
+    orderIndex.reserve(orderIndex.size() + count);
+    if (count > 0) {
+        buyLevels.reserve();
+        sellLevels.reserve();
+    }
+}
+
+const PoolStats& OrderBook::getOrderPoolStats() const {
+    return orderPool.getStats();
+}
+
+// orders are written best level first and in queue order,
+// so loading the file back preserves price-time priority
+void OrderBook::saveToFile(const std::string& filename, const TraderBase& traderBase, OrderId lastOrderId) {
+    std::ofstream file(filename);
+    if(file.is_open()){
+        file << textStorageHeader() << std::endl;
+        file << "last-order-id " << std::max(lastOrderId, this->lastOrderId) << std::endl;
+        forEachOrder([&](CommandType side, const Order& order) {
+            file << (side == CommandType::BUY ? "buy " : "sell ") << order.serialize(traderBase) << std::endl;
+        });
         file.close();
     }
     else{
@@ -83,28 +266,50 @@ void OrderBook::saveToFile(const std::string& filename) {
     }
 }
 
-void OrderBook::loadFromFile(const std::string& filename) {
+bool OrderBook::loadFromFile(const std::string& filename, TraderBase& traderBase) {
     std::ifstream file(filename);
     std::string line;
     if(file.is_open()){
+        bool decimal;
+        if (!readTextStorageHeader(file, filename, decimal)) {
+            return false;
+        }
+        size_t converted = 0;
         while (std::getline(file, line)) {
-            std::stringstream ss(line);
-            std::string type, orderData;
-            ss >> type;
-            std::getline(ss, orderData);
-            auto order = Order::deserialize(orderData);
-            if (order) {
-                if (type == "sell") {
-                    addSellOrder(std::move(order));
-                } else if (type == "buy") {
-                    addBuyOrder(std::move(order));
+            Tokenizer tokens(line);
+            std::string_view type;
+            tokens.next(type);
+            if (type == "last-order-id") {
+                OrderId id;
+                if (nextNumber(tokens, id)) {
+                    lastOrderId = std::max(lastOrderId, id);
                 }
+                continue;
+            }
+            if (type.empty()) continue;
+            auto order = decimal ? Order::deserializeDecimal(tokens.remaining(), lastOrderId + 1, orderPool, traderBase)
+                                 : Order::deserialize(tokens.remaining(), orderPool, traderBase);
+            // an order that could not rest, or a second one with the same id,
+            // which would take the first one's place in the index
+            if (!order || (type != "buy" && type != "sell") || findOrder(order->getId())) {
+                std::cerr << "Invalid order in " << filename << ": \"" << line << "\"" << std::endl;
+                return false;
+            }
+            converted += decimal;
+            if (type == "sell") {
+                addSellOrder(std::move(order));
+            } else {
+                addBuyOrder(std::move(order));
             }
         }
         file.close();
+        if (converted > 0) {
+            std::cerr << "Converted " << converted << " orders of " << filename << " from decimal prices to ticks" << std::endl;
+        }
+        return true;
     }
     else{
         std::cerr << "Error opening a file: " << filename << std::endl;
+        return false;
     }
-    
-}
\ No newline at end of file
+}
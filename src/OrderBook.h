@@ -1,25 +1,204 @@
 #ifndef ORDERBOOK_H
 #define ORDERBOOK_H
 
-#include <vector>
-#include <memory>
+#include <algorithm>
+#include <functional>
+#include <memory_resource>
+#include <unordered_map>
 #include "Order.h"
+#include "CommandType.h"
+#include "PriceLadder.h"
+
+// aggregated quantity at one price (L2 market data)
+struct DepthLevel {
+    Price price = 0;
+    int64_t quantity = 0;
+    uint32_t orders = 0;
+};
+
+// outcome of matching an incoming order
+struct MatchResult {
+    int remaining = 0;     // quantity neither filled nor removed by self-trade prevention
+    bool selfTrade = false; // self-trade prevention cancelled the remaining quantity
+};
+
+// the best levels of both sides, as published for readers on other threads
+struct BookDepth {
+    static constexpr size_t LEVELS = 10;
+    size_t buyLevels = 0;
+    size_t sellLevels = 0;
+    DepthLevel buy[LEVELS];
+    DepthLevel sell[LEVELS];
+};
 
 class OrderBook {
 public:
     OrderBook();
-    void addSellOrder(std::unique_ptr<Order> newOrder);
-    void addBuyOrder(std::unique_ptr<Order> newOrder);
+    ~OrderBook();
+    OrderBook(const OrderBook&) = delete;
+    OrderBook& operator=(const OrderBook&) = delete;
+    OrderPtr createOrder(OrderId id, int quantity, Price pricePerOne, time_t timestamp, TraderId trader);
+    void addSellOrder(OrderPtr newOrder);
+    void addBuyOrder(OrderPtr newOrder);
     void popSellOrder();
     void popBuyOrder();
     Order* getFrontSellOrder();
     Order* getFrontBuyOrder();
-    void saveToFile(const std::string& filename);
-    void loadFromFile(const std::string& filename);
+
+    // resting orders by id; all three are O(1)
+    Order* findOrder(OrderId id) const;
+    bool cancelOrder(OrderId id);
+    // reducing the quantity keeps the order's queue priority,
+    // increasing it moves the order to the back of its price level
+    bool amendOrder(OrderId id, int quantity);
+    // highest id added to the book so far
+    OrderId getLastOrderId() const;
+
+    // Match an incoming order against the opposite side before it would
+    // rest, so a marketable order never enters the book. `onFill(resting,
+    // quantity)` is called for every fill before the resting order is
+    // reduced. Resting orders of the same trader are handled in place
+    // according to `selfTrade`; `onSelfTrade(resting, quantity)` is called
+    // before such an order is cancelled or reduced by `quantity`. Unless
+    // self-trade prevention cancelled it, the caller may add the remaining
+    // quantity to the book.
+    template <typename FillHandler, typename SelfTradeHandler>
+    MatchResult matchBuyOrder(TraderId trader, Price limit, int quantity, SelfTradePrevention selfTrade,
+                              FillHandler&& onFill, SelfTradeHandler&& onSelfTrade) {
+        return sweep(sellLevels, [limit](Price price) { return price <= limit; }, trader, quantity, selfTrade, onFill, onSelfTrade);
+    }
+
+    template <typename FillHandler, typename SelfTradeHandler>
+    MatchResult matchSellOrder(TraderId trader, Price limit, int quantity, SelfTradePrevention selfTrade,
+                               FillHandler&& onFill, SelfTradeHandler&& onSelfTrade) {
+        return sweep(buyLevels, [limit](Price price) { return price >= limit; }, trader, quantity, selfTrade, onFill, onSelfTrade);
+    }
+
+    // Quantity an incoming order could fill right now, up to `quantity`,
+    // following the same rules as matchBuyOrder / matchSellOrder; the
+    // quantity self-trade prevention would decrement counts as filled.
+    // Does not modify the book (used for fill-or-kill).
+    int getFillableBuyQuantity(TraderId trader, Price limit, int quantity, SelfTradePrevention selfTrade) const;
+    int getFillableSellQuantity(TraderId trader, Price limit, int quantity, SelfTradePrevention selfTrade) const;
+
+    // whether an incoming order at `limit` would cross the opposite side
+    bool buyWouldCross(Price limit) const;
+    bool sellWouldCross(Price limit) const;
+
+    // Copy up to `count` price levels of a side into `levels`, best first;
+    // returns the number copied. O(count): the levels keep their totals
+    // up to date, so no order is visited.
+    size_t getBuyDepth(DepthLevel* levels, size_t count) const;
+    size_t getSellDepth(DepthLevel* levels, size_t count) const;
+    void getDepth(BookDepth& depth) const;
+
+    // Call `visit(side, order)` for every resting order, sell side first,
+    // best level first and in queue order within a level, so adding the
+    // orders back in this order preserves price-time priority.
+    template <typename Visitor>
+    void forEachOrder(Visitor&& visit) const {
+        for (const auto& [price, level] : sellLevels) {
+            for (const Order* order = level.head; order; order = order->next) {
+                visit(CommandType::SELL, *order);
+            }
+        }
+        for (const auto& [price, level] : buyLevels) {
+            for (const Order* order = level.head; order; order = order->next) {
+                visit(CommandType::BUY, *order);
+            }
+        }
+    }
+    // room for `count` more resting orders, for bulk loading; with any, also
+    // the price levels around the best prices (see PriceLadder::reserve)
+    void reserve(size_t count);
+
+    const PoolStats& getOrderPoolStats() const;
+    // the text storage also keeps the last order id handed out, so ids of
+    // orders that have left the book are not given out again after a restart.
+    // Loading converts files of the first, decimal format, giving their
+    // orders ids in file order; false if the file cannot be read or holds
+    // an order without a positive quantity and price, or a repeated id.
+    void saveToFile(const std::string& filename, const TraderBase& traderBase, OrderId lastOrderId);
+    bool loadFromFile(const std::string& filename, TraderBase& traderBase);
 
 private:
-    std::vector<std::unique_ptr<Order>> sellOrders;
-    std::vector<std::unique_ptr<Order>> buyOrders;
+    // fill against the best levels while they cross. A trader's orders
+    // never match each other: a resting order of the same trader is
+    // cancelled or reduced where it is, so the book is never left crossed
+    // and the orders behind it stay reachable.
+    template <typename Levels, typename Crosses, typename FillHandler, typename SelfTradeHandler>
+    MatchResult sweep(Levels& levels, Crosses crosses, TraderId trader, int quantity, SelfTradePrevention selfTrade,
+                      FillHandler& onFill, SelfTradeHandler& onSelfTrade) {
+        while (quantity > 0) {
+            Price price;
+            PriceLevel* level = levels.best(price);
+            if (!level || !crosses(price)) break;
+            Order* resting = level->head;
+            if (resting->getTrader() == trader) {
+                if (selfTrade == SelfTradePrevention::CANCEL_NEWEST) return {quantity, true};
+                if (selfTrade == SelfTradePrevention::DECREMENT) {
+                    int decrement = std::min(quantity, resting->getQuantity());
+                    onSelfTrade(*resting, decrement);
+                    quantity -= decrement;
+                    reduceFront(levels, price, *level, decrement);
+                    continue;
+                }
+                onSelfTrade(*resting, resting->getQuantity());
+                removeFront(levels, price, *level);
+                if (selfTrade == SelfTradePrevention::CANCEL_BOTH) return {quantity, true};
+                continue;
+            }
+
+            int fillQuantity = std::min(quantity, resting->getQuantity());
+            onFill(*resting, fillQuantity);
+            quantity -= fillQuantity;
+            reduceFront(levels, price, *level, fillQuantity);
+        }
+        return {quantity, false};
+    }
+
+    // take `quantity` off the first order of a level, removing it once empty
+    template <typename Levels>
+    void reduceFront(Levels& levels, Price price, PriceLevel& level, int quantity) {
+        level.head->changeQuantity(quantity);
+        level.quantity -= quantity;
+        if (level.head->getQuantity() == 0) {
+            removeFront(levels, price, level);
+        }
+    }
+
+    // remove the first order of a level, and the level once it is empty
+    template <typename Levels>
+    void removeFront(Levels& levels, Price price, PriceLevel& level) {
+        releaseOrder(level.popFront());
+        if (!level.head) {
+            levels.erase(price);
+        }
+    }
+
+    template <typename Levels, typename Crosses>
+    int fillable(const Levels& levels, Crosses crosses, TraderId trader, int quantity, SelfTradePrevention selfTrade) const;
+    template <typename Levels>
+    void pushOrder(Levels& levels, OrderPtr newOrder);
+    template <typename Levels>
+    void popOrder(Levels& levels);
+    template <typename Levels>
+    void releaseAll(Levels& levels);
+    template <typename Levels>
+    static size_t copyDepth(const Levels& levels, DepthLevel* depth, size_t count);
+    void releaseOrder(Order* order);
+
+    // orders are owned by the pool while resting in the book;
+    // index nodes and levels outside the ladder windows are recycled
+    // through levelResource
+    ObjectPool<Order> orderPool;
+    std::pmr::unsynchronized_pool_resource levelResource;
+
+    // best level first: lowest ask / highest bid
+    PriceLadder<std::less<Price>> sellLevels;
+    PriceLadder<std::greater<Price>> buyLevels;
+    std::pmr::unordered_map<OrderId, Order*> orderIndex;
+    OrderId lastOrderId = 0;
 };
 
-#endif // ORDERBOOK_H
\ No newline at end of file
+#endif // ORDERBOOK_H
@@ -0,0 +1,121 @@
+#include "Price.h"
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <format>
+#include <iostream>
+
+static PriceConfig priceConfig;
+static int64_t unitsPerWhole = 100; // 10^scale
+
+bool setPriceConfig(const PriceConfig& config) {
+    // keep 10^scale and the integer part of realistic prices well inside int64_t
+    if (config.scale < 0 || config.scale > 9 || config.tickSize <= 0) {
+        return false;
+    }
+    priceConfig = config;
+    unitsPerWhole = 1;
+    for (int i = 0; i < config.scale; ++i) unitsPerWhole *= 10;
+    return true;
+}
+
+const PriceConfig& getPriceConfig() { return priceConfig; }
+
+bool parsePriceUnits(std::string_view text, int64_t& units) {
+    constexpr int64_t maxValue = std::numeric_limits<int64_t>::max();
+    size_t pos = 0;
+    bool negative = false;
+    if (pos < text.size() && (text[pos] == '-' || text[pos] == '+')) {
+        negative = text[pos] == '-';
+        ++pos;
+    }
+
+    int64_t whole = 0;
+    bool hasDigits = false;
+    for (; pos < text.size() && text[pos] >= '0' && text[pos] <= '9'; ++pos) {
+        if (whole > (maxValue - 9) / 10) return false;
+        whole = whole * 10 + (text[pos] - '0');
+        hasDigits = true;
+    }
+
+    // fractional digits beyond the configured scale are only allowed if they are zeros
+    int64_t fraction = 0;
+    if (pos < text.size() && text[pos] == '.') {
+        ++pos;
+        int digits = 0;
+        for (; pos < text.size() && text[pos] >= '0' && text[pos] <= '9'; ++pos, ++digits) {
+            hasDigits = true;
+            if (digits < priceConfig.scale) {
+                fraction = fraction * 10 + (text[pos] - '0');
+            } else if (text[pos] != '0') {
+                return false;
+            }
+        }
+        for (; digits < priceConfig.scale; ++digits) fraction *= 10;
+    }
+    if (!hasDigits || pos != text.size()) return false;
+
+    if (whole > (maxValue - fraction) / unitsPerWhole) return false;
+    units = whole * unitsPerWhole + fraction;
+    if (negative) units = -units;
+    return true;
+}
+
+bool totalPriceToTicks(int64_t totalUnits, int quantity, Price& ticks) {
+    if (quantity <= 0 || totalUnits % quantity != 0) return false;
+    int64_t unitsPerOne = totalUnits / quantity;
+    if (unitsPerOne % priceConfig.tickSize != 0) return false;
+    ticks = unitsPerOne / priceConfig.tickSize;
+    return true;
+}
+
+std::string textStorageHeader() {
+    return std::format("format 2 scale {} tick {}", priceConfig.scale, priceConfig.tickSize);
+}
+
+bool readTextStorageHeader(std::istream& file, const std::string& filename, bool& decimal) {
+    std::string line;
+    decimal = !std::getline(file, line) || !line.starts_with("format ");
+    if (decimal) {
+        file.clear();
+        file.seekg(0);
+        return true;
+    }
+    if (line != textStorageHeader()) {
+        std::cerr << "File " << filename << " has the header \"" << line << "\"; this engine reads \""
+                  << textStorageHeader() << "\"" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool decimalPriceToTicks(std::string_view text, Price& ticks) {
+    double price;
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), price);
+    if (error != std::errc() || end != text.data() + text.size() || !std::isfinite(price) || price <= 0) {
+        return false;
+    }
+    double rounded = std::round(price * static_cast<double>(unitsPerWhole) / static_cast<double>(priceConfig.tickSize));
+    if (rounded < 1 || rounded > static_cast<double>(std::numeric_limits<Price>::max() / 2)) {
+        return false;
+    }
+    ticks = static_cast<Price>(rounded);
+    return true;
+}
+
+std::string formatPrice(Price ticks) {
+    int64_t units = ticks * priceConfig.tickSize;
+    std::string sign = units < 0 ? "-" : "";
+    uint64_t magnitude = units < 0 ? 0 - static_cast<uint64_t>(units) : static_cast<uint64_t>(units);
+    uint64_t whole = magnitude / unitsPerWhole;
+    uint64_t fraction = magnitude % unitsPerWhole;
+    if (fraction == 0) {
+        return std::format("{}{}", sign, whole);
+    }
+
+    // zero-pad the fraction to `scale` digits, then drop trailing zeros
+    std::string digits = std::to_string(fraction);
+    digits.insert(0, priceConfig.scale - digits.size(), '0');
+    digits.erase(digits.find_last_not_of('0') + 1);
+    return std::format("{}{}.{}", sign, whole, digits);
+}
@@ -0,0 +1,44 @@
+#ifndef PRICE_H
+#define PRICE_H
+
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <string_view>
+
+// prices are stored as a whole number of ticks
+using Price = int64_t;
+
+// `scale`: number of decimal places of the smallest price unit (2 -> 0.01).
+// `tickSize`: minimum price increment, in smallest price units.
+struct PriceConfig {
+    int scale = 2;
+    int64_t tickSize = 1;
+};
+
+// process-wide price configuration, set once at startup
+bool setPriceConfig(const PriceConfig& config);
+const PriceConfig& getPriceConfig();
+
+// parse a decimal string into smallest price units
+bool parsePriceUnits(std::string_view text, int64_t& units);
+
+// convert a total price for `quantity` items into ticks per item;
+// fails when the per-item price is not a whole number of ticks
+bool totalPriceToTicks(int64_t totalUnits, int quantity, Price& ticks);
+
+// format ticks as a decimal price for display
+std::string formatPrice(Price ticks);
+
+// First line of the text storage files (orders.txt, transactions.txt):
+// their format and the price configuration their ticks are in. Files of
+// the first format have no header and decimal prices per item.
+std::string textStorageHeader();
+// Read the header of a text storage file, if any. Sets `decimal` for a
+// file of the first format, which then reads from its start again; false,
+// with a message, for a header of another format or price configuration.
+bool readTextStorageHeader(std::istream& file, const std::string& filename, bool& decimal);
+// a decimal price per item of the first format, rounded to the nearest tick
+bool decimalPriceToTicks(std::string_view text, Price& ticks);
+
+#endif // PRICE_H
@@ -0,0 +1,284 @@
+#ifndef PRICELADDER_H
+#define PRICELADDER_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include "Order.h"
+#include "Price.h"
+
+// resting orders at a single price, kept in arrival (FIFO) order
+// as an intrusive list through the orders themselves
+struct PriceLevel {
+    Order* head = nullptr;
+    Order* tail = nullptr;
+    int64_t quantity = 0; // total quantity of the orders, kept up to date on every change
+    uint32_t orderCount = 0;
+    void pushBack(Order* order);
+    Order* popFront();
+    void remove(Order* order);
+    void relink(); // point the orders back at the level after it moved
+};
+
+// Set of indexes in [0, SIZE) in three levels of 64-bit words: a bit of a
+// summary word is set while the word it stands for has any bit set. The
+// whole top level is one word, so finding the next set index in either
+// direction is at most three count-zeros instructions.
+class OccupancyBitmap {
+public:
+    static constexpr int BITS = 18;
+    static constexpr size_t SIZE = size_t(1) << BITS;
+    static constexpr size_t NONE = SIZE;
+
+    bool empty() const { return top == 0; }
+
+    void set(size_t index) {
+        leaf[index >> 6] |= bit(index);
+        middle[index >> 12] |= bit(index >> 6);
+        top |= bit(index >> 12);
+    }
+
+    void clear(size_t index) {
+        if (leaf[index >> 6] &= ~bit(index)) return;
+        if (middle[index >> 12] &= ~bit(index >> 6)) return;
+        top &= ~bit(index >> 12);
+    }
+
+    // lowest set index >= from, or NONE
+    size_t findNext(size_t from) const {
+        size_t word = from >> 6;
+        uint64_t bits = leaf[word] & (~uint64_t(0) << (from & 63));
+        if (!bits) {
+            size_t group = word >> 6;
+            uint64_t words = middle[group] & above(word & 63);
+            if (!words) {
+                uint64_t groups = top & above(group);
+                if (!groups) return NONE;
+                group = std::countr_zero(groups);
+                words = middle[group];
+            }
+            word = (group << 6) | std::countr_zero(words);
+            bits = leaf[word];
+        }
+        return (word << 6) | std::countr_zero(bits);
+    }
+
+    // highest set index <= from, or NONE
+    size_t findPrevious(size_t from) const {
+        size_t word = from >> 6;
+        uint64_t bits = leaf[word] & (~uint64_t(0) >> (63 - (from & 63)));
+        if (!bits) {
+            size_t group = word >> 6;
+            uint64_t words = middle[group] & below(word & 63);
+            if (!words) {
+                uint64_t groups = top & below(group);
+                if (!groups) return NONE;
+                group = 63 - std::countl_zero(groups);
+                words = middle[group];
+            }
+            word = (group << 6) | (63 - std::countl_zero(words));
+            bits = leaf[word];
+        }
+        return (word << 6) | (63 - std::countl_zero(bits));
+    }
+
+private:
+    static uint64_t bit(size_t index) { return uint64_t(1) << (index & 63); }
+    // the bits of a word above / below position `index`
+    static uint64_t above(size_t index) { return index == 63 ? 0 : ~uint64_t(0) << (index + 1); }
+    static uint64_t below(size_t index) { return (uint64_t(1) << index) - 1; }
+
+    uint64_t top = 0;
+    std::array<uint64_t, (SIZE >> 12)> middle{};
+    std::array<uint64_t, (SIZE >> 6)> leaf{};
+};
+
+// The price levels of one side of the book, best first by `Better`
+// (std::less for asks, std::greater for bids).
+//
+// Levels within a window of OccupancyBitmap::SIZE ticks are stored flat,
+// indexed by their distance from the bottom of the window, and the bitmap
+// tells which of them hold orders; finding the best level or the next one
+// after a level empties never searches. The window is centred on the first
+// price added to an empty side. Levels outside it go to an ordered map, so
+// any price works, only slower; once the window empties while the map still
+// holds levels, it is centred again on the best of them and takes over the
+// ones it then covers, so an outlier first price does not leave the side in
+// the map for good. Window levels are allocated in pages of
+// PAGE_SIZE on first use and kept, so a price range in use does not
+// allocate again.
+//
+// A level counts as occupied from operator[] until erase(), which the
+// caller does as soon as its last order has left it.
+template <typename Better>
+class PriceLadder {
+public:
+    static constexpr bool ASCENDING = std::is_same_v<Better, std::less<Price>>;
+    static constexpr int PAGE_BITS = 12;
+    static constexpr size_t PAGE_SIZE = size_t(1) << PAGE_BITS;
+
+    explicit PriceLadder(std::pmr::memory_resource* resource)
+        : occupied(std::make_unique<OccupancyBitmap>()), outside(resource) {}
+
+    // the level at `price`, created if it was not occupied
+    PriceLevel& operator[](Price price) {
+        if (occupied->empty() && outside.empty()) {
+            base = price - static_cast<Price>(OccupancyBitmap::SIZE / 2);
+        }
+        if (!inWindow(price)) {
+            return outside[price];
+        }
+        size_t index = static_cast<size_t>(price - base);
+        occupied->set(index);
+        return slot(index);
+    }
+
+    void erase(Price price) {
+        if (inWindow(price)) {
+            occupied->clear(static_cast<size_t>(price - base));
+            if (occupied->empty() && !outside.empty()) {
+                recentre(outside.begin()->first);
+            }
+        } else {
+            outside.erase(price);
+        }
+    }
+
+    // allocate the pages within PAGE_SIZE ticks of the best level, or of the
+    // window centre, where the first price of an empty side goes, so the
+    // levels around the market do not allocate when first used
+    void reserve() {
+        size_t centre = OccupancyBitmap::SIZE / 2;
+        Price price;
+        if (best(price) && inWindow(price)) {
+            centre = static_cast<size_t>(price - base);
+        }
+        size_t first = centre >= PAGE_SIZE ? centre - PAGE_SIZE : 0;
+        size_t last = std::min(centre + PAGE_SIZE, OccupancyBitmap::SIZE - 1);
+        for (size_t page = first >> PAGE_BITS; page <= last >> PAGE_BITS; ++page) {
+            slot(page << PAGE_BITS);
+        }
+    }
+
+    // the best occupied level and its price, or nullptr when the side is empty
+    PriceLevel* best(Price& price) {
+        return const_cast<PriceLevel*>(std::as_const(*this).best(price));
+    }
+
+    const PriceLevel* best(Price& price) const {
+        return find(ASCENDING ? std::numeric_limits<Price>::min() : std::numeric_limits<Price>::max(), price);
+    }
+
+    // read-only iteration over the occupied levels, best first, as
+    // (price, level) pairs like a map
+    struct Entry {
+        Price first;
+        const PriceLevel& second;
+    };
+
+    class Iterator {
+    public:
+        Iterator(const PriceLadder* ladder, const PriceLevel* level, Price price)
+            : ladder(ladder), level(level), price(price) {}
+        Entry operator*() const { return {price, *level}; }
+        Iterator& operator++() {
+            level = ladder->find(ASCENDING ? price + 1 : price - 1, price);
+            return *this;
+        }
+        bool operator==(const Iterator& other) const { return level == other.level; }
+
+    private:
+        const PriceLadder* ladder;
+        const PriceLevel* level;
+        Price price;
+    };
+
+    Iterator begin() const {
+        Price price = 0;
+        const PriceLevel* level = best(price);
+        return Iterator(this, level, price);
+    }
+
+    Iterator end() const {
+        return Iterator(this, nullptr, 0);
+    }
+
+private:
+    bool inWindow(Price price) const {
+        return price >= base && price < base + static_cast<Price>(OccupancyBitmap::SIZE);
+    }
+
+    // the window level at `index`, allocating its page on first use
+    PriceLevel& slot(size_t index) {
+        auto& page = pages[index >> PAGE_BITS];
+        if (!page) {
+            page = std::make_unique<PriceLevel[]>(PAGE_SIZE);
+        }
+        return page[index & (PAGE_SIZE - 1)];
+    }
+
+    // centre the empty window on `price` and move the outside levels it
+    // covers into it
+    void recentre(Price price) {
+        base = price - static_cast<Price>(OccupancyBitmap::SIZE / 2);
+        for (auto it = outside.begin(); it != outside.end();) {
+            if (!inWindow(it->first)) {
+                ++it;
+                continue;
+            }
+            size_t index = static_cast<size_t>(it->first - base);
+            PriceLevel& level = slot(index);
+            level = it->second;
+            level.relink();
+            occupied->set(index);
+            it = outside.erase(it);
+        }
+    }
+
+    // the best occupied level at `from` or worse; sets `price` to its price
+    const PriceLevel* find(Price from, Price& price) const {
+        const PriceLevel* level = nullptr;
+        if (!occupied->empty()) {
+            size_t index = OccupancyBitmap::NONE;
+            if (ASCENDING) {
+                if (from < base) {
+                    index = occupied->findNext(0);
+                } else if (inWindow(from)) {
+                    index = occupied->findNext(static_cast<size_t>(from - base));
+                }
+            } else {
+                if (!inWindow(from) && from >= base) {
+                    index = occupied->findPrevious(OccupancyBitmap::SIZE - 1);
+                } else if (inWindow(from)) {
+                    index = occupied->findPrevious(static_cast<size_t>(from - base));
+                }
+            }
+            if (index != OccupancyBitmap::NONE) {
+                level = &pages[index >> PAGE_BITS][index & (PAGE_SIZE - 1)];
+                price = base + static_cast<Price>(index);
+            }
+        }
+        if (!outside.empty()) {
+            auto it = outside.lower_bound(from);
+            if (it != outside.end() && (!level || Better()(it->first, price))) {
+                level = &it->second;
+                price = it->first;
+            }
+        }
+        return level;
+    }
+
+    Price base = 0; // price of the first window level
+    std::unique_ptr<OccupancyBitmap> occupied;
+    std::array<std::unique_ptr<PriceLevel[]>, (OccupancyBitmap::SIZE >> PAGE_BITS)> pages;
+    std::pmr::map<Price, PriceLevel, Better> outside;
+};
+
+#endif // PRICELADDER_H
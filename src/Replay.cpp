@@ -0,0 +1,74 @@
+#include "Replay.h"
+#include <iostream>
+#include "CommandParser.h"
+
+Replay::Replay(const std::vector<std::string>& symbols, SelfTradePrevention selfTrade, const RiskLimits& riskLimits)
+    : selfTrade(selfTrade) {
+    for (SymbolId id = 0; id < symbols.size(); ++id) {
+        auto instrument = std::make_unique<Instrument>(id, symbols[id], "");
+        instrument->risk.setLimits(riskLimits);
+        instruments.push_back(std::move(instrument));
+    }
+}
+
+void Replay::run(std::istream& input) {
+    std::string line;
+    ParsedCommand parsed;
+    uint64_t lineNumber = 0;
+    while (std::getline(input, line)) {
+        ++lineNumber;
+        ParseError error = parseReplayLine(line, parsed);
+        if (error == ParseError::EMPTY) continue;
+        if (error != ParseError::NONE) {
+            std::cerr << "Line " << lineNumber << ": " << describeParseError(error, parsed) << std::endl;
+            continue;
+        }
+        if (parsed.type == CommandType::EXIT) break;
+        if (parsed.type != CommandType::BUY && parsed.type != CommandType::SELL && parsed.type != CommandType::CANCEL
+            && parsed.type != CommandType::AMEND) {
+            continue;
+        }
+
+        // without "@SYMBOL" the command is for the first symbol
+        SymbolId symbol = 0;
+        if (!parsed.symbol.empty()) {
+            while (symbol < instruments.size() && instruments[symbol]->symbol != parsed.symbol) ++symbol;
+            if (symbol == instruments.size()) {
+                std::cerr << "Line " << lineNumber << ": Unknown symbol: " << parsed.symbol << std::endl;
+                continue;
+            }
+        }
+        Instrument& instrument = *instruments[symbol];
+        Command command;
+        if (parsed.type == CommandType::CANCEL || parsed.type == CommandType::AMEND) {
+            TraderId trader;
+            if (!traderBase.findTrader(parsed.trader, trader)) {
+                // a trader without orders owns none to change
+                ++commands;
+                ++rejected;
+                continue;
+            }
+            command = Command{.type = parsed.type, .orderId = parsed.orderId, .trader = trader, .quantity = parsed.quantity, .symbol = symbol};
+        } else {
+            TraderId trader = traderBase.addTrader(parsed.trader);
+            command = Command{parsed.type, ++instrument.lastOrderId, trader, parsed.quantity, parsed.pricePerOne,
+                              parsed.orderType, symbol, selfTrade};
+        }
+        command.timestamp = parsed.timestamp;
+        ++commands;
+        if (instrument.engine.submit(command, parsed.timestamp).status != CommandStatus::DONE) {
+            ++rejected;
+        }
+    }
+}
+
+bool Replay::writeLog(std::ostream& log) const {
+    bool complete = true;
+    for (const auto& instrument : instruments) {
+        complete = complete && instrument->txList.forEachTransaction(0, [&](const Transaction& tx) {
+            log << instrument->symbol << ' ' << tx.serialize(traderBase) << '\n';
+        });
+    }
+    log.flush();
+    return complete && log.good();
+}
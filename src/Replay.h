@@ -0,0 +1,48 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "CommandType.h"
+#include "Instrument.h"
+#include "RiskTable.h"
+#include "TraderBase.h"
+
+// Matches a recorded command stream, one "<timestamp> <command>" line each,
+// at full speed on the calling thread. A replay starts from empty books,
+// traders and histories kept in memory only: nothing is loaded, journaled
+// or saved, so the same stream always gives the same fills. Orders get ids
+// per symbol from 1 in the order they appear and match at the timestamp of
+// their line. Queries only read state and are skipped; "exit" ends the
+// stream like its end does.
+class Replay {
+public:
+    Replay(const std::vector<std::string>& symbols, SelfTradePrevention selfTrade, const RiskLimits& riskLimits);
+
+    // match the commands of `input`; invalid lines are reported on
+    // std::cerr with their line number and skipped
+    void run(std::istream& input);
+
+    // the fills of the replay, symbol by symbol and oldest first, one
+    // "<symbol> <transaction>" line each in the text storage format
+    bool writeLog(std::ostream& log) const;
+
+    // the state of symbol `id` (its index in the symbol list) after the replay
+    const Instrument& getInstrument(SymbolId id) const { return *instruments[id]; }
+
+    uint64_t getCommands() const { return commands; } // matched, rejected ones included
+    uint64_t getRejected() const { return rejected; }
+
+private:
+    TraderBase traderBase;
+    std::vector<std::unique_ptr<Instrument>> instruments;
+    SelfTradePrevention selfTrade;
+    uint64_t commands = 0;
+    uint64_t rejected = 0;
+};
+
+#endif // REPLAY_H
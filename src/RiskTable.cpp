@@ -0,0 +1,45 @@
+#include "RiskTable.h"
+#include <algorithm>
+
+void RiskTable::setLimits(const RiskLimits& newLimits) {
+    limits = newLimits;
+}
+
+const RiskLimits& RiskTable::getLimits() const {
+    return limits;
+}
+
+void RiskTable::orderAdded(TraderId trader, bool isBuy, int64_t quantity, Price price) {
+    TraderRisk& risk = at(trader);
+    (isBuy ? risk.openBuy : risk.openSell) += quantity;
+    risk.openNotional += price * quantity;
+}
+
+void RiskTable::orderRemoved(TraderId trader, bool isBuy, int64_t quantity, Price price) {
+    TraderRisk& risk = at(trader);
+    (isBuy ? risk.openBuy : risk.openSell) -= quantity;
+    risk.openNotional -= price * quantity;
+}
+
+void RiskTable::filled(TraderId buyer, TraderId seller, int64_t quantity) {
+    at(buyer).position += quantity;
+    at(seller).position -= quantity;
+}
+
+TraderRisk RiskTable::getTraderRisk(TraderId trader) const {
+    return trader < traders.size() ? traders[trader] : TraderRisk{};
+}
+
+void RiskTable::reserve(size_t count) {
+    if (count > traders.size()) {
+        traders.resize(count);
+    }
+}
+
+// grows the table for a trader seen for the first time
+TraderRisk& RiskTable::at(TraderId trader) {
+    if (trader >= traders.size()) {
+        traders.resize(std::max<size_t>(trader + 1, traders.size() * 2));
+    }
+    return traders[trader];
+}
@@ -0,0 +1,64 @@
+#ifndef RISKTABLE_H
+#define RISKTABLE_H
+
+#include <vector>
+#include "Price.h"
+#include "TraderBase.h"
+
+// pre-trade limits per trader and symbol; 0 means no limit
+struct RiskLimits {
+    int64_t maxPosition = 0;     // absolute net position, counting open orders as filled
+    int64_t maxOpenQuantity = 0; // quantity of open orders, both sides
+    int64_t maxOpenNotional = 0; // price * quantity of open orders, in ticks
+};
+
+// what a trader holds and has working on one symbol
+struct TraderRisk {
+    int64_t position = 0;     // bought minus sold
+    int64_t openBuy = 0;      // resting buy quantity
+    int64_t openSell = 0;     // resting sell quantity
+    int64_t openNotional = 0; // price * quantity of resting orders, in ticks
+};
+
+// Position and exposure of every trader on a symbol, in a flat table
+// indexed by trader id. The matching engine updates it as orders rest,
+// fill and leave the book, and checks every new order against the limits
+// before matching it. Owned by the matching thread of the symbol.
+class RiskTable {
+public:
+    void setLimits(const RiskLimits& newLimits);
+    const RiskLimits& getLimits() const;
+
+    // Whether an order of `quantity` at `price` (0 for a market order, which
+    // adds no notional) stays within the limits if it rests in full: the
+    // worst-case position counts every open order on the same side as
+    // filled. O(1) and allocation-free.
+    bool allows(TraderId trader, bool isBuy, int64_t quantity, Price price) const {
+        if (trader >= traders.size()) return allows(TraderRisk{}, isBuy, quantity, price);
+        return allows(traders[trader], isBuy, quantity, price);
+    }
+
+    // resting quantity added to or removed from the book
+    void orderAdded(TraderId trader, bool isBuy, int64_t quantity, Price price);
+    void orderRemoved(TraderId trader, bool isBuy, int64_t quantity, Price price);
+    void filled(TraderId buyer, TraderId seller, int64_t quantity);
+
+    TraderRisk getTraderRisk(TraderId trader) const;
+    // room for `count` traders, so updates do not allocate either
+    void reserve(size_t count);
+
+private:
+    bool allows(const TraderRisk& risk, bool isBuy, int64_t quantity, Price price) const {
+        int64_t worstPosition = isBuy ? risk.position + risk.openBuy + quantity
+                                      : -(risk.position - risk.openSell - quantity);
+        return (limits.maxPosition == 0 || worstPosition <= limits.maxPosition)
+            && (limits.maxOpenQuantity == 0 || risk.openBuy + risk.openSell + quantity <= limits.maxOpenQuantity)
+            && (limits.maxOpenNotional == 0 || risk.openNotional + price * quantity <= limits.maxOpenNotional);
+    }
+    TraderRisk& at(TraderId trader);
+
+    RiskLimits limits;
+    std::vector<TraderRisk> traders; // indexed by TraderId
+};
+
+#endif // RISKTABLE_H
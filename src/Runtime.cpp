@@ -0,0 +1,69 @@
+#include "Runtime.h"
+#include <iostream>
+#ifdef __linux__
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+bool pinThread(std::thread& thread, unsigned cpu) {
+#ifdef __linux__
+    if (cpu >= CPU_SETSIZE) {
+        std::cerr << "Could not pin a thread to CPU " << cpu << ": at most " << CPU_SETSIZE << " CPUs are supported"
+                  << std::endl;
+        return false;
+    }
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    if (pthread_setaffinity_np(thread.native_handle(), sizeof(cpus), &cpus) != 0) {
+        std::cerr << "Could not pin a thread to CPU " << cpu << std::endl;
+        return false;
+    }
+    return true;
+#else
+    std::cerr << "Thread pinning is not supported on this platform" << std::endl;
+    return false;
+#endif
+}
+
+bool lockMemory() {
+#ifdef __linux__
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        std::cerr << "Could not lock the process memory; check the memlock limit (ulimit -l)" << std::endl;
+        return false;
+    }
+    return true;
+#else
+    std::cerr << "Locking memory is not supported on this platform" << std::endl;
+    return false;
+#endif
+}
+
+void adviseHugePages(void* data, size_t bytes) {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    uintptr_t pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    uintptr_t begin = (reinterpret_cast<uintptr_t>(data) + pageSize - 1) & ~(pageSize - 1);
+    uintptr_t end = (reinterpret_cast<uintptr_t>(data) + bytes) & ~(pageSize - 1);
+    if (end > begin) {
+        // only a hint: without transparent huge pages the range keeps normal pages
+        madvise(reinterpret_cast<void*>(begin), end - begin, MADV_HUGEPAGE);
+    }
+#else
+    (void)data;
+    (void)bytes;
+#endif
+}
+
+PageFaults getPageFaults() {
+    PageFaults faults;
+#ifdef __linux__
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        faults.minor = static_cast<uint64_t>(usage.ru_minflt);
+        faults.major = static_cast<uint64_t>(usage.ru_majflt);
+    }
+#endif
+    return faults;
+}
@@ -0,0 +1,32 @@
+#ifndef RUNTIME_H
+#define RUNTIME_H
+
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+// Operating system tuning for the latency-sensitive threads. Everything
+// here is a best effort: where the platform or the process limits do not
+// allow it, the call reports failure and the engine runs as before.
+
+// pin a thread to one CPU; only supported on Linux
+bool pinThread(std::thread& thread, unsigned cpu);
+
+// keep every page of the process, current and future, in RAM and fault
+// future allocations in when they are made, not when first touched
+bool lockMemory();
+
+// ask for transparent huge pages on the whole pages inside [data, data + bytes);
+// for large allocations, before they are first written
+void adviseHugePages(void* data, size_t bytes);
+// allocations at least this large are worth advising
+constexpr size_t HUGE_PAGE_SIZE = size_t(2) << 20;
+
+// page faults of the process so far
+struct PageFaults {
+    uint64_t minor = 0; // served from memory
+    uint64_t major = 0; // needed disk I/O
+};
+PageFaults getPageFaults();
+
+#endif // RUNTIME_H
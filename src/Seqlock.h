@@ -0,0 +1,66 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Single-writer sequence lock. The writer never waits; readers retry while
+// a write is in progress and always get a consistent copy of the value.
+// The value is kept in atomic words so that concurrent reads are not data
+// races. Best for small, trivially copyable values written often and read
+// by a thread that only needs the latest one.
+template <typename T>
+class Seqlock {
+    static_assert(std::is_trivially_copyable_v<T>, "Seqlock needs a trivially copyable type");
+
+public:
+    Seqlock() : Seqlock(T{}) {}
+    explicit Seqlock(const T& value) { store(value); }
+    Seqlock(const Seqlock&) = delete;
+    Seqlock& operator=(const Seqlock&) = delete;
+
+    // writer thread only
+    void store(const T& value) {
+        std::array<uint64_t, WORDS> words{};
+        std::memcpy(words.data(), static_cast<const void*>(&value), sizeof(T));
+        uint64_t current = sequence.load(std::memory_order_relaxed);
+        sequence.store(current + 1, std::memory_order_relaxed); // odd: write in progress
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; ++i) {
+            data[i].store(words[i], std::memory_order_relaxed);
+        }
+        sequence.store(current + 2, std::memory_order_release);
+    }
+
+    // any thread; returns the sequence number of the copy
+    uint64_t load(T& value) const {
+        std::array<uint64_t, WORDS> words;
+        uint64_t before, after;
+        do {
+            before = sequence.load(std::memory_order_acquire);
+            for (size_t i = 0; i < WORDS; ++i) {
+                words[i] = data[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence.load(std::memory_order_relaxed);
+        } while ((before & 1) || before != after);
+        // trivially copyable, but the payloads have default member
+        // initializers, which -Wclass-memaccess would flag
+        std::memcpy(static_cast<void*>(&value), words.data(), sizeof(T));
+        return before;
+    }
+
+    // changes with every store
+    uint64_t getSequence() const { return sequence.load(std::memory_order_acquire); }
+
+private:
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    alignas(64) std::atomic<uint64_t> sequence{0};
+    std::array<std::atomic<uint64_t>, WORDS> data{};
+};
+
+#endif // SEQLOCK_H
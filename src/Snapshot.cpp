@@ -0,0 +1,397 @@
+#include "Snapshot.h"
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <vector>
+#ifdef _WIN32
+#include <fstream>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char SNAPSHOT_MAGIC[8] = {'O', 'M', 'E', 'S', 'N', 'A', 'P', '\0'};
+static const char TRANSACTIONS_MAGIC[8] = {'O', 'M', 'E', 'T', 'X', 'N', 'S', '\0'};
+
+// All records are multiples of 8 bytes so the checksum can work on words.
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    int32_t priceScale;      // prices are stored in ticks of this configuration
+    uint32_t reserved;
+    int64_t tickSize;
+    uint64_t traderCount;    // followed by traderCount uint32 name end offsets,
+    uint64_t nameBytes;      // the names, and orderCount order records
+    uint64_t orderCount;
+    uint64_t lastOrderId;
+    uint64_t transactionCount;
+    uint64_t transactionsChecksum;
+    uint64_t checksum;       // over the header with this field zeroed and the payload
+    uint64_t journalSequence; // last journaled command included; version 2 on
+};
+static_assert(sizeof(SnapshotHeader) == 96, "snapshot header layout changed");
+// version 1 headers end before journalSequence
+static const size_t HEADER_SIZE_V1 = offsetof(SnapshotHeader, journalSequence);
+// the transactions file has not changed since version 1
+static const uint32_t TRANSACTIONS_VERSION = 1;
+
+struct SnapshotOrder {
+    uint64_t id;
+    int64_t pricePerOne;
+    int64_t timestamp;
+    int32_t quantity;
+    uint32_t trader;
+    uint8_t side;            // CommandType::BUY or CommandType::SELL
+    uint8_t reserved[7];
+};
+static_assert(sizeof(SnapshotOrder) == 40, "snapshot order layout changed");
+
+struct TransactionsHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+};
+static_assert(sizeof(TransactionsHeader) == 16, "transactions header layout changed");
+
+struct SnapshotTransaction {
+    int64_t pricePerOne;
+    int64_t timestamp;
+    int32_t quantity;
+    uint32_t seller;
+    uint32_t buyer;
+    uint32_t reserved;
+};
+static_assert(sizeof(SnapshotTransaction) == 32, "snapshot transaction layout changed");
+
+static const uint64_t CHECKSUM_SEED = 14695981039346656037ull;
+
+// word-at-a-time FNV-style hash; fast enough to verify gigabytes at load
+// time and can be continued over data appended later
+static uint64_t checksum(const void* data, size_t size, uint64_t hash = CHECKSUM_SEED) {
+    const char* bytes = static_cast<const char*>(data);
+    for (size_t i = 0; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes + i, 8);
+        hash = (hash ^ word) * 1099511628211ull;
+        hash ^= hash >> 32;
+    }
+    return hash;
+}
+
+static size_t padTo8(size_t size) {
+    return (size + 7) & ~size_t(7);
+}
+
+static void syncFile(std::FILE* file) {
+    std::fflush(file);
+#ifdef _WIN32
+    _commit(_fileno(file));
+#else
+    fsync(fileno(file));
+#endif
+}
+
+// read-only view of a whole file
+class MappedFile {
+public:
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+#ifdef _WIN32
+    explicit MappedFile(const std::string& filename) {
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) return;
+        buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        data = buffer.data();
+        size = buffer.size();
+        opened = true;
+    }
+    ~MappedFile() = default;
+#else
+    explicit MappedFile(const std::string& filename) {
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat status;
+        if (fstat(fd, &status) == 0) {
+            opened = true;
+            size = static_cast<size_t>(status.st_size);
+            if (size > 0) {
+                void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapping != MAP_FAILED) {
+                    madvise(mapping, size, MADV_SEQUENTIAL | MADV_WILLNEED);
+                    data = static_cast<const char*>(mapping);
+                } else {
+                    opened = false;
+                }
+            }
+        }
+        ::close(fd);
+    }
+    ~MappedFile() {
+        if (data) munmap(const_cast<char*>(data), size);
+    }
+#endif
+
+    const char* data = nullptr;
+    size_t size = 0;
+    bool opened = false;
+
+private:
+#ifdef _WIN32
+    std::vector<char> buffer;
+#endif
+};
+
+Snapshot::Snapshot(std::string snapshotFile, std::string transactionsFile)
+    : snapshotFile(std::move(snapshotFile)), transactionsFile(std::move(transactionsFile)),
+      transactionsChecksum(CHECKSUM_SEED) {}
+
+bool Snapshot::exists() const {
+    std::error_code error;
+    return std::filesystem::exists(snapshotFile, error);
+}
+
+bool Snapshot::load(TraderBase& traderBase, OrderBook& orderBook, TransactionList& txList, OrderId& lastOrderId,
+                    uint64_t& journalSequence) {
+    MappedFile snapshot(snapshotFile);
+    if (!snapshot.opened) {
+        std::cerr << "Error opening a file: " << snapshotFile << std::endl;
+        return false;
+    }
+    SnapshotHeader header{};
+    if (snapshot.size < HEADER_SIZE_V1) {
+        std::cerr << "Invalid snapshot file: " << snapshotFile << std::endl;
+        return false;
+    }
+    std::memcpy(&header, snapshot.data, HEADER_SIZE_V1);
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0) {
+        std::cerr << "Invalid snapshot file: " << snapshotFile << std::endl;
+        return false;
+    }
+    if (header.version != VERSION && header.version != 1) {
+        std::cerr << "Unsupported snapshot version " << header.version << " in " << snapshotFile << std::endl;
+        return false;
+    }
+    size_t headerSize = header.version == 1 ? HEADER_SIZE_V1 : sizeof(header);
+    if (header.headerSize != headerSize || snapshot.size < headerSize) {
+        std::cerr << "Invalid snapshot file: " << snapshotFile << std::endl;
+        return false;
+    }
+    std::memcpy(&header, snapshot.data, headerSize);
+    const PriceConfig& priceConfig = getPriceConfig();
+    if (header.priceScale != priceConfig.scale || header.tickSize != priceConfig.tickSize) {
+        std::cerr << "Snapshot " << snapshotFile << " was written with price scale " << header.priceScale
+                  << " and tick size " << header.tickSize << std::endl;
+        return false;
+    }
+
+    size_t namesOffset = headerSize + padTo8(header.traderCount * sizeof(uint32_t));
+    size_t ordersOffset = namesOffset + padTo8(header.nameBytes);
+    if (header.traderCount > snapshot.size || header.nameBytes > snapshot.size || header.orderCount > snapshot.size
+        || snapshot.size != ordersOffset + header.orderCount * sizeof(SnapshotOrder)) {
+        std::cerr << "Invalid snapshot file: " << snapshotFile << std::endl;
+        return false;
+    }
+    SnapshotHeader unsealed = header;
+    unsealed.checksum = 0;
+    if (checksum(snapshot.data + headerSize, snapshot.size - headerSize, checksum(&unsealed, headerSize)) != header.checksum) {
+        std::cerr << "Snapshot " << snapshotFile << " is corrupt (checksum mismatch)" << std::endl;
+        return false;
+    }
+
+    // verify the transactions the snapshot vouches for before building anything
+    MappedFile transactions(transactionsFile);
+    const char* txRecords = nullptr;
+    if (header.transactionCount > 0) {
+        TransactionsHeader txHeader;
+        if (!transactions.opened || transactions.size < sizeof(txHeader)) {
+            std::cerr << "Error opening a file: " << transactionsFile << std::endl;
+            return false;
+        }
+        std::memcpy(&txHeader, transactions.data, sizeof(txHeader));
+        if (std::memcmp(txHeader.magic, TRANSACTIONS_MAGIC, sizeof(txHeader.magic)) != 0 || txHeader.version != TRANSACTIONS_VERSION
+            || txHeader.headerSize != sizeof(txHeader)
+            || (transactions.size - sizeof(txHeader)) / sizeof(SnapshotTransaction) < header.transactionCount) {
+            std::cerr << "Invalid transactions file: " << transactionsFile << std::endl;
+            return false;
+        }
+        txRecords = transactions.data + sizeof(txHeader);
+        if (checksum(txRecords, header.transactionCount * sizeof(SnapshotTransaction)) != header.transactionsChecksum) {
+            std::cerr << "Transactions file " << transactionsFile << " is corrupt (checksum mismatch)" << std::endl;
+            return false;
+        }
+    }
+
+    // traders; ids are remapped in case the registry is not empty
+    std::vector<TraderId> traderIds(header.traderCount);
+    traderBase.reserve(header.traderCount);
+    const char* nameEnds = snapshot.data + headerSize;
+    const char* names = snapshot.data + namesOffset;
+    uint32_t nameStart = 0;
+    for (uint64_t i = 0; i < header.traderCount; ++i) {
+        uint32_t nameEnd;
+        std::memcpy(&nameEnd, nameEnds + i * sizeof(nameEnd), sizeof(nameEnd));
+        if (nameEnd < nameStart || nameEnd > header.nameBytes) nameEnd = nameStart;
+        traderIds[i] = traderBase.addTrader(std::string_view(names + nameStart, nameEnd - nameStart));
+        nameStart = nameEnd;
+    }
+    auto resolve = [&traderIds](uint32_t id) { return id < traderIds.size() ? traderIds[id] : id; };
+
+    // orders are stored in priority order, so appending them rebuilds the queues
+    orderBook.reserve(header.orderCount);
+    const char* orders = snapshot.data + ordersOffset;
+    for (uint64_t i = 0; i < header.orderCount; ++i) {
+        SnapshotOrder record;
+        std::memcpy(&record, orders + i * sizeof(record), sizeof(record));
+        OrderPtr order = orderBook.createOrder(record.id, record.quantity, record.pricePerOne, record.timestamp, resolve(record.trader));
+        if (record.side == static_cast<uint8_t>(CommandType::BUY)) {
+            orderBook.addBuyOrder(std::move(order));
+        } else {
+            orderBook.addSellOrder(std::move(order));
+        }
+    }
+
+    txList.reserve(header.transactionCount);
+    for (uint64_t i = 0; i < header.transactionCount; ++i) {
+        SnapshotTransaction record;
+        std::memcpy(&record, txRecords + i * sizeof(record), sizeof(record));
+        txList.appendTransaction(Transaction(record.quantity, record.pricePerOne, record.timestamp,
+                                             resolve(record.seller), resolve(record.buyer)));
+    }
+    txList.publishTransactions();
+
+    lastOrderId = std::max<OrderId>(lastOrderId, header.lastOrderId);
+    journalSequence = header.journalSequence;
+    persistedTransactions = header.transactionCount;
+    transactionsChecksum = header.transactionsChecksum;
+    return true;
+}
+
+// Write the transactions added since the last save after the persisted
+// ones, overwriting anything a failed save left behind.
+bool Snapshot::appendTransactions(const TransactionList& txList) {
+    std::FILE* file = persistedTransactions > 0 ? std::fopen(transactionsFile.c_str(), "r+b") : nullptr;
+    if (!file) {
+        persistedTransactions = 0;
+        transactionsChecksum = CHECKSUM_SEED;
+        file = std::fopen(transactionsFile.c_str(), "wb");
+        if (!file) {
+            std::cerr << "Error opening a file: " << transactionsFile << std::endl;
+            return false;
+        }
+        TransactionsHeader txHeader{};
+        std::memcpy(txHeader.magic, TRANSACTIONS_MAGIC, sizeof(txHeader.magic));
+        txHeader.version = TRANSACTIONS_VERSION;
+        txHeader.headerSize = sizeof(txHeader);
+        std::fwrite(&txHeader, sizeof(txHeader), 1, file);
+    } else {
+        std::fseek(file, static_cast<long>(sizeof(TransactionsHeader) + persistedTransactions * sizeof(SnapshotTransaction)), SEEK_SET);
+    }
+
+    std::vector<SnapshotTransaction> batch;
+    batch.reserve(4096);
+    uint64_t newChecksum = transactionsChecksum;
+    bool written = true;
+    auto flush = [&]() {
+        newChecksum = checksum(batch.data(), batch.size() * sizeof(SnapshotTransaction), newChecksum);
+        written = written && std::fwrite(batch.data(), sizeof(SnapshotTransaction), batch.size(), file) == batch.size();
+        batch.clear();
+    };
+    bool complete = txList.forEachTransaction(persistedTransactions, [&](const Transaction& tx) {
+        batch.push_back(SnapshotTransaction{tx.getPricePerOne(), tx.getDate(), tx.getQuantity(), tx.getSeller(), tx.getBuyer(), 0});
+        if (batch.size() == batch.capacity()) flush();
+    });
+    flush();
+    written = written && complete;
+    syncFile(file);
+    std::fclose(file);
+    if (!written) {
+        std::cerr << "Error writing a file: " << transactionsFile << std::endl;
+        return false;
+    }
+    // committed by the snapshot; until then the old count stays authoritative
+    transactionsChecksum = newChecksum;
+    return true;
+}
+
+bool Snapshot::save(const TraderBase& traderBase, const OrderBook& orderBook, const TransactionList& txList, OrderId lastOrderId,
+                    uint64_t journalSequence) {
+    // restored if the save fails, the files on disk still match them
+    uint64_t previousCount = persistedTransactions;
+    uint64_t previousChecksum = transactionsChecksum;
+    auto fail = [&]() {
+        persistedTransactions = previousCount;
+        transactionsChecksum = previousChecksum;
+        return false;
+    };
+    if (!appendTransactions(txList)) {
+        return fail();
+    }
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = VERSION;
+    header.headerSize = sizeof(header);
+    header.priceScale = getPriceConfig().scale;
+    header.tickSize = getPriceConfig().tickSize;
+    header.lastOrderId = std::max(lastOrderId, orderBook.getLastOrderId());
+    header.transactionCount = txList.getSize();
+    header.transactionsChecksum = transactionsChecksum;
+    header.journalSequence = journalSequence;
+
+    // payload is built in memory; orders and names are small next to the transactions
+    std::vector<uint32_t> nameEnds;
+    std::string names;
+    header.traderCount = traderBase.getSize();
+    nameEnds.reserve(header.traderCount);
+    for (TraderId id = 0; id < header.traderCount; ++id) {
+        names += traderBase.getName(id);
+        nameEnds.push_back(static_cast<uint32_t>(names.size()));
+    }
+    header.nameBytes = names.size();
+    std::vector<SnapshotOrder> orders;
+    orderBook.forEachOrder([&orders](CommandType side, const Order& order) {
+        orders.push_back(SnapshotOrder{order.getId(), order.getPricePerOne(), order.getDate(), order.getQuantity(),
+                                       order.getTrader(), static_cast<uint8_t>(side), {}});
+    });
+    header.orderCount = orders.size();
+
+    std::vector<char> payload(padTo8(nameEnds.size() * sizeof(uint32_t)) + padTo8(names.size()) + orders.size() * sizeof(SnapshotOrder));
+    char* out = payload.data();
+    std::memcpy(out, nameEnds.data(), nameEnds.size() * sizeof(uint32_t));
+    out += padTo8(nameEnds.size() * sizeof(uint32_t));
+    std::memcpy(out, names.data(), names.size());
+    out += padTo8(names.size());
+    std::memcpy(out, orders.data(), orders.size() * sizeof(SnapshotOrder));
+    header.checksum = checksum(payload.data(), payload.size(), checksum(&header, sizeof(header)));
+
+    // write aside and rename, so a crash leaves either the old or the new snapshot
+    std::string temporaryFile = snapshotFile + ".tmp";
+    std::FILE* file = std::fopen(temporaryFile.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Error opening a file: " << temporaryFile << std::endl;
+        return fail();
+    }
+    bool written = std::fwrite(&header, sizeof(header), 1, file) == 1
+                && std::fwrite(payload.data(), 1, payload.size(), file) == payload.size();
+    syncFile(file);
+    std::fclose(file);
+    std::error_code error;
+    if (written) {
+        std::filesystem::rename(temporaryFile, snapshotFile, error);
+    }
+    if (!written || error) {
+        std::cerr << "Error writing a file: " << snapshotFile << std::endl;
+        return fail();
+    }
+    persistedTransactions = header.transactionCount;
+    // drop records a failed save may have left past the end
+    std::filesystem::resize_file(transactionsFile, sizeof(TransactionsHeader) + persistedTransactions * sizeof(SnapshotTransaction), error);
+    return true;
+}
@@ -0,0 +1,48 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+#include "OrderBook.h"
+#include "TraderBase.h"
+#include "TransactionList.h"
+
+// Versioned, checksummed binary store of the engine state, loaded through
+// mmap with bulk construction instead of parsing text line by line.
+//
+// The state is kept in two files:
+// - the snapshot file holds the trader names, the resting orders (in
+//   priority order) and the number and checksum of persisted transactions;
+//   it is small and rewritten atomically (write, fsync, rename) on save.
+// - the transactions file is an array of fixed-size records that only ever
+//   grows, so saving writes just the transactions added since the last save.
+// The snapshot file is the commit point: transactions beyond the count it
+// records (e.g. after a crash during a save) are ignored and overwritten.
+class Snapshot {
+public:
+    static constexpr uint32_t VERSION = 2;
+
+    Snapshot(std::string snapshotFile, std::string transactionsFile);
+
+    // Fill empty containers from the files. Returns false, leaving the
+    // containers untouched, if the snapshot is missing, of another version
+    // or price configuration, or fails its checksum. `journalSequence` is
+    // set to the sequence number of the last journaled command the snapshot
+    // includes (0 for version 1 snapshots, which did not record it).
+    bool load(TraderBase& traderBase, OrderBook& orderBook, TransactionList& txList, OrderId& lastOrderId,
+              uint64_t& journalSequence);
+    bool save(const TraderBase& traderBase, const OrderBook& orderBook, const TransactionList& txList, OrderId lastOrderId,
+              uint64_t journalSequence);
+    bool exists() const;
+
+private:
+    bool appendTransactions(const TransactionList& txList);
+
+    std::string snapshotFile;
+    std::string transactionsFile;
+    // transactions already in the transactions file and their checksum
+    uint64_t persistedTransactions = 0;
+    uint64_t transactionsChecksum;
+};
+
+#endif // SNAPSHOT_H
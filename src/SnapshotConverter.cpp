@@ -0,0 +1,69 @@
+#include "TraderBase.h"
+#include "OrderBook.h"
+#include "TransactionList.h"
+#include "Snapshot.h"
+#include <iostream>
+#include <cstring>
+
+// Converts the engine's storage between the text files and the binary snapshot.
+//
+//   SnapshotConverter to-binary [storage dir] [--price-scale N] [--tick-size N]
+//   SnapshotConverter to-text [storage dir] [--price-scale N] [--tick-size N]
+//
+// to-binary reads traders.txt, orders.txt and transactions.txt and writes
+// snapshot.bin and transactions.bin; to-text does the reverse. The storage
+// directory defaults to ../storage, as for the engine. The price options
+// must match those the engine runs with.
+int main(int argc, char* argv[]) {
+    if (argc < 2 || (std::strcmp(argv[1], "to-binary") != 0 && std::strcmp(argv[1], "to-text") != 0)) {
+        std::cerr << "Usage: " << argv[0] << " to-binary|to-text [storage dir] [--price-scale N] [--tick-size N]" << std::endl;
+        return 1;
+    }
+    bool toBinary = std::strcmp(argv[1], "to-binary") == 0;
+    std::string directory = "../storage";
+    PriceConfig priceConfig;
+    for (int i = 2; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--price-scale") == 0 && i + 1 < argc) {
+            priceConfig.scale = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--tick-size") == 0 && i + 1 < argc) {
+            priceConfig.tickSize = std::atoll(argv[++i]);
+        } else if (argv[i][0] != '-') {
+            directory = argv[i];
+        } else {
+            std::cerr << "Unknown argument: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+    if (!setPriceConfig(priceConfig)) {
+        std::cerr << "Invalid price configuration: scale must be 0-9 and tick size positive" << std::endl;
+        return 1;
+    }
+
+    TraderBase traderBase;
+    OrderBook orderBook;
+    TransactionList txList;
+    Snapshot snapshot(directory + "/snapshot.bin", directory + "/transactions.bin");
+    if (toBinary) {
+        traderBase.loadFromFile(directory + "/traders.txt");
+        if (!orderBook.loadFromFile(directory + "/orders.txt", traderBase)
+            || !txList.loadFromFile(directory + "/transactions.txt", traderBase)) {
+            return 1;
+        }
+        // the text files do not record journal sequence numbers
+        if (!snapshot.save(traderBase, orderBook, txList, orderBook.getLastOrderId(), 0)) {
+            return 1;
+        }
+    } else {
+        OrderId lastOrderId = 0;
+        uint64_t journalSequence = 0;
+        if (!snapshot.load(traderBase, orderBook, txList, lastOrderId, journalSequence)) {
+            return 1;
+        }
+        traderBase.saveToFile(directory + "/traders.txt");
+        orderBook.saveToFile(directory + "/orders.txt", traderBase, lastOrderId);
+        txList.saveToFile(directory + "/transactions.txt", traderBase);
+    }
+    std::cout << "Converted " << traderBase.getSize() << " traders, " << orderBook.getOrderPoolStats().live
+              << " orders and " << txList.getSize() << " transactions" << std::endl;
+    return 0;
+}
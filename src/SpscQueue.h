@@ -0,0 +1,112 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+
+// how a thread waits for the other side of the queue
+enum class WaitStrategy {
+    BUSY_SPIN,  // poll continuously; lowest latency, burns a core
+    SPIN_YIELD, // poll for a while, then yield the CPU between polls
+    BLOCKING    // poll for a while, then sleep until notified
+};
+
+// Bounded lock-free single-producer / single-consumer ring buffer.
+// Exactly one thread may push and exactly one thread may pop.
+// `Capacity` must be a power of two.
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    explicit SpscQueue(WaitStrategy strategy = WaitStrategy::BLOCKING) : strategy(strategy) {}
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // only valid while neither side is running
+    void setWaitStrategy(WaitStrategy newStrategy) { strategy = newStrategy; }
+
+    // producer side
+    bool tryPush(const T& item) {
+        size_t currentTail = tail.load(std::memory_order_relaxed);
+        if (currentTail - cachedHead == Capacity) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (currentTail - cachedHead == Capacity) return false;
+        }
+        buffer[currentTail & (Capacity - 1)] = item;
+        tail.store(currentTail + 1, std::memory_order_release);
+        if (strategy == WaitStrategy::BLOCKING) {
+            // pairs with the fence in pop(): either the consumer sees the new
+            // tail before sleeping, or we see that it is asleep and wake it
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (consumerSleeping.load(std::memory_order_relaxed)) {
+                tail.notify_one();
+            }
+        }
+        return true;
+    }
+
+    // waits while the queue is full; a full queue means the consumer is
+    // behind, so the producer only spins and yields and never sleeps
+    void push(const T& item) {
+        for (unsigned spins = 0; !tryPush(item); ++spins) {
+            if (strategy != WaitStrategy::BUSY_SPIN && spins >= spinLimit) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    // consumer side
+    bool tryPop(T& item) {
+        size_t currentHead = head.load(std::memory_order_relaxed);
+        if (currentHead == cachedTail) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (currentHead == cachedTail) return false;
+        }
+        item = buffer[currentHead & (Capacity - 1)];
+        head.store(currentHead + 1, std::memory_order_release);
+        return true;
+    }
+
+    // waits according to the wait strategy while the queue is empty
+    void pop(T& item) {
+        for (unsigned spins = 0; !tryPop(item); ++spins) {
+            if (strategy == WaitStrategy::BUSY_SPIN || spins < spinLimit) {
+                continue;
+            }
+            if (strategy == WaitStrategy::SPIN_YIELD) {
+                std::this_thread::yield();
+                continue;
+            }
+            size_t observed = head.load(std::memory_order_relaxed);
+            consumerSleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (tail.load(std::memory_order_relaxed) == observed) {
+                tail.wait(observed, std::memory_order_acquire);
+            }
+            consumerSleeping.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    // approximate number of queued items, safe to call from any thread
+    size_t size() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr unsigned spinLimit = 1024;
+
+    // producer and consumer indices live on separate cache lines, each next
+    // to the other side's index as last seen by its owner
+    alignas(64) std::atomic<size_t> head{0};
+    size_t cachedTail = 0;
+    alignas(64) std::atomic<size_t> tail{0};
+    size_t cachedHead = 0;
+    alignas(64) std::atomic<bool> consumerSleeping{false};
+    WaitStrategy strategy;
+    alignas(64) std::array<T, Capacity> buffer{};
+};
+
+#endif // SPSCQUEUE_H
@@ -0,0 +1,68 @@
+#include "Stats.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <format>
+
+size_t LatencyHistogram::bucketOf(uint64_t value) {
+    if (value < SUB_BUCKETS) return static_cast<size_t>(value);
+    int shift = std::bit_width(value) - 1 - SUB_BUCKET_BITS;
+    size_t bucket = SUB_BUCKETS + static_cast<size_t>(shift) * SUB_BUCKETS + ((value >> shift) - SUB_BUCKETS);
+    return std::min(bucket, static_cast<size_t>(BUCKETS - 1));
+}
+
+uint64_t LatencyHistogram::bucketEnd(size_t bucket) {
+    if (bucket < SUB_BUCKETS) return bucket;
+    size_t shift = (bucket - SUB_BUCKETS) / SUB_BUCKETS;
+    uint64_t subBucket = SUB_BUCKETS + (bucket - SUB_BUCKETS) % SUB_BUCKETS;
+    return ((subBucket + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(int64_t nanoseconds) {
+    uint64_t value = nanoseconds > 0 ? static_cast<uint64_t>(nanoseconds) : 0;
+    counts[bucketOf(value)].add();
+    count.add();
+    sum.add(value);
+    max.raise(value);
+}
+
+uint64_t LatencyHistogram::getCount() const {
+    return count.get();
+}
+
+uint64_t LatencyHistogram::getMax() const {
+    return max.get();
+}
+
+uint64_t LatencyHistogram::getMean() const {
+    uint64_t recorded = count.get();
+    return recorded ? sum.get() / recorded : 0;
+}
+
+uint64_t LatencyHistogram::getPercentile(double percentile) const {
+    // the buckets are read one by one while the writer may be recording,
+    // so the total is taken from the buckets themselves
+    uint64_t total = 0;
+    for (const StatCounter& bucket : counts) total += bucket.get();
+    if (total == 0) return 0;
+    uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percentile / 100.0 * total)));
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < counts.size(); ++bucket) {
+        seen += counts[bucket].get();
+        if (seen >= target) return std::min(bucketEnd(bucket), max.get());
+    }
+    return max.get();
+}
+
+std::string LatencyHistogram::summary() const {
+    return std::format("count {}, mean {}, p50 {}, p99 {}, p99.9 {}, max {}", getCount(), formatDuration(getMean()),
+                       formatDuration(getPercentile(50)), formatDuration(getPercentile(99)),
+                       formatDuration(getPercentile(99.9)), formatDuration(getMax()));
+}
+
+std::string formatDuration(uint64_t nanoseconds) {
+    if (nanoseconds < 1000) return std::format("{}ns", nanoseconds);
+    if (nanoseconds < 1000000) return std::format("{:.1f}us", nanoseconds / 1e3);
+    if (nanoseconds < 1000000000) return std::format("{:.2f}ms", nanoseconds / 1e6);
+    return std::format("{:.2f}s", nanoseconds / 1e9);
+}
@@ -0,0 +1,82 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// steady clock reading for latency measurements
+inline int64_t steadyNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Counter or gauge with a single writer thread, readable from any thread.
+// Updating it is a plain load and store, no locked instruction.
+class StatCounter {
+public:
+    void add(uint64_t amount = 1) { value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed); }
+    void set(uint64_t newValue) { value.store(newValue, std::memory_order_relaxed); }
+    void raise(uint64_t candidate) {
+        if (candidate > value.load(std::memory_order_relaxed)) value.store(candidate, std::memory_order_relaxed);
+    }
+    uint64_t get() const { return value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> value{0};
+};
+
+// HDR-style latency histogram: 32 linear sub-buckets per power of two, so
+// every recorded value is kept with a relative error below 1/32 (about 3%),
+// from 1 ns up to several hours. Fixed size; recording never locks or
+// allocates. Same threading rules as StatCounter: one writer, any readers.
+class LatencyHistogram {
+public:
+    void record(int64_t nanoseconds);
+
+    uint64_t getCount() const;
+    uint64_t getMax() const;
+    uint64_t getMean() const;
+    // smallest value that `percentile` percent of the recorded values do not exceed
+    uint64_t getPercentile(double percentile) const;
+    // e.g. "count 1200, mean 1.2us, p50 1.1us, p99 3.4us, p99.9 8.0us, max 12.1us"
+    std::string summary() const;
+
+private:
+    static constexpr int SUB_BUCKET_BITS = 5;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr int MAGNITUDES = 40; // up to 2^45 ns
+    static constexpr int BUCKETS = SUB_BUCKETS * (MAGNITUDES + 1);
+
+    static size_t bucketOf(uint64_t value);
+    static uint64_t bucketEnd(size_t bucket); // largest value in the bucket
+
+    std::array<StatCounter, BUCKETS> counts;
+    StatCounter count;
+    StatCounter sum;
+    StatCounter max;
+};
+
+// Statistics of one matching shard. Apart from maxQueueDepth, which the
+// input thread keeps when it queues a command, everything is recorded by
+// the shard's thread.
+struct ShardStats {
+    LatencyHistogram queueLatency;    // line read by the input thread -> command dequeued
+    LatencyHistogram matchLatency;    // command dequeued -> matched and journaled
+    LatencyHistogram endToEndLatency; // line read -> matched and journaled
+    StatCounter commands;
+    StatCounter rejected;             // not found, post-only, fill-or-kill or self-trade rejections
+    StatCounter maxQueueDepth;
+};
+
+// Statistics of one symbol, recorded by the thread of the shard owning it
+struct InstrumentStats {
+    StatCounter fills;          // since the engine started
+    StatCounter restingOrders;  // current book depth
+};
+
+// "850ns", "12.3us", "4.56ms" or "1.20s"
+std::string formatDuration(uint64_t nanoseconds);
+
+#endif // STATS_H
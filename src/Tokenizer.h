@@ -0,0 +1,49 @@
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+#include <charconv>
+#include <string_view>
+
+// Splits a line into whitespace-separated tokens without copying it; the
+// tokens point into the line.
+class Tokenizer {
+public:
+    explicit Tokenizer(std::string_view text) : rest(text) {}
+
+    // false when no token is left
+    bool next(std::string_view& token) {
+        size_t start = rest.find_first_not_of(" \t\r\n");
+        if (start == std::string_view::npos) {
+            rest = {};
+            return false;
+        }
+        size_t end = rest.find_first_of(" \t\r\n", start);
+        if (end == std::string_view::npos) end = rest.size();
+        token = rest.substr(start, end - start);
+        rest.remove_prefix(end);
+        return true;
+    }
+
+    // the text after the last token read
+    std::string_view remaining() const { return rest; }
+
+private:
+    std::string_view rest;
+};
+
+// parse a whole token as a decimal integer
+template <typename T>
+bool parseNumber(std::string_view token, T& value) {
+    const char* end = token.data() + token.size();
+    auto [last, error] = std::from_chars(token.data(), end, value);
+    return error == std::errc() && last == end && !token.empty();
+}
+
+// read the next token as a decimal integer
+template <typename T>
+bool nextNumber(Tokenizer& tokens, T& value) {
+    std::string_view token;
+    return tokens.next(token) && parseNumber(token, value);
+}
+
+#endif // TOKENIZER_H
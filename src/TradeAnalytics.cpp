@@ -0,0 +1,76 @@
+#include "TradeAnalytics.h"
+#include <algorithm>
+
+Price getVwap(int64_t notional, int64_t volume) {
+    return volume > 0 ? (notional + volume / 2) / volume : 0;
+}
+
+TradeAnalytics::TradeAnalytics(std::vector<int64_t> intervals) {
+    setIntervals(std::move(intervals));
+}
+
+void TradeAnalytics::setIntervals(std::vector<int64_t> newIntervals) {
+    intervals = std::move(newIntervals);
+    series.clear();
+    for (int64_t interval : intervals) {
+        series.push_back(Series{interval, {}});
+    }
+}
+
+const std::vector<int64_t>& TradeAnalytics::getIntervals() const {
+    return intervals;
+}
+
+void TradeAnalytics::addFill(const Transaction& tx) {
+    Price price = tx.getPricePerOne();
+    int64_t quantity = tx.getQuantity();
+    ++fills;
+    volume += quantity;
+    notional += price * quantity;
+
+    TraderId highest = std::max(tx.getBuyer(), tx.getSeller());
+    if (highest >= traders.size()) {
+        traders.resize(std::max<size_t>(highest + 1, traders.size() * 2));
+    }
+    traders[tx.getBuyer()].bought += quantity;
+    traders[tx.getSeller()].sold += quantity;
+
+    for (Series& bars : series) {
+        time_t start = tx.getDate() - tx.getDate() % bars.interval;
+        if (bars.candles.empty() || start > bars.candles.back().start) {
+            if (bars.candles.size() == HISTORY) {
+                bars.candles.pop_front();
+            }
+            bars.candles.push_back(Candle{start, price, price, price, price});
+        }
+        Candle& candle = bars.candles.back();
+        candle.high = std::max(candle.high, price);
+        candle.low = std::min(candle.low, price);
+        candle.close = price;
+        candle.volume += quantity;
+        candle.notional += price * quantity;
+        ++candle.fills;
+    }
+}
+
+void TradeAnalytics::reserve(size_t count) {
+    if (count > traders.size()) {
+        traders.resize(count);
+    }
+}
+
+bool TradeAnalytics::getCandles(int64_t interval, size_t count, std::vector<Candle>& candles) const {
+    auto bars = std::find_if(series.begin(), series.end(), [interval](const Series& s) { return s.interval == interval; });
+    if (bars == series.end()) return false;
+    count = std::min(count, bars->candles.size());
+    candles.assign(bars->candles.end() - count, bars->candles.end());
+    return true;
+}
+
+uint64_t TradeAnalytics::getFills() const { return fills; }
+int64_t TradeAnalytics::getVolume() const { return volume; }
+int64_t TradeAnalytics::getNotional() const { return notional; }
+
+TraderVolume TradeAnalytics::getTraderVolume(TraderId trader) const {
+    return trader < traders.size() ? traders[trader] : TraderVolume{};
+}
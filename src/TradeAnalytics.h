@@ -0,0 +1,75 @@
+#ifndef TRADEANALYTICS_H
+#define TRADEANALYTICS_H
+
+#include <ctime>
+#include <deque>
+#include <vector>
+#include "Price.h"
+#include "TraderBase.h"
+#include "Transaction.h"
+
+// OHLCV bar of one interval
+struct Candle {
+    time_t start = 0; // multiple of the interval
+    Price open = 0;
+    Price high = 0;
+    Price low = 0;
+    Price close = 0;
+    int64_t volume = 0;
+    int64_t notional = 0; // sum of price * quantity, in ticks
+    uint32_t fills = 0;
+};
+
+// quantity a trader bought and sold on one symbol
+struct TraderVolume {
+    int64_t bought = 0;
+    int64_t sold = 0;
+};
+
+// volume weighted average price in ticks, rounded to the nearest tick
+Price getVwap(int64_t notional, int64_t volume);
+
+// Aggregates over a symbol's fills, updated as every fill is added, so no
+// query ever rescans the transaction history: candles of each configured
+// interval (the latest HISTORY of each), the running VWAP and every
+// trader's bought and sold quantity. Owned by the matching thread of the
+// symbol, like the book.
+class TradeAnalytics {
+public:
+    static constexpr size_t HISTORY = 1000;
+
+    explicit TradeAnalytics(std::vector<int64_t> intervals = {60, 300, 3600});
+    // intervals in seconds; clears all candles
+    void setIntervals(std::vector<int64_t> intervals);
+    const std::vector<int64_t>& getIntervals() const;
+
+    // Fills arrive in time order; one dated before the current candle of an
+    // interval (the clock went back) is added to that candle.
+    void addFill(const Transaction& tx);
+
+    // the latest `count` candles of `interval`, oldest first; false if the
+    // interval is not one of the configured ones. Intervals without fills
+    // have no candle.
+    bool getCandles(int64_t interval, size_t count, std::vector<Candle>& candles) const;
+    uint64_t getFills() const;
+    int64_t getVolume() const;
+    int64_t getNotional() const;
+    TraderVolume getTraderVolume(TraderId trader) const;
+    // room for `count` traders, so fills of new traders do not allocate
+    void reserve(size_t count);
+
+private:
+    struct Series {
+        int64_t interval;
+        std::deque<Candle> candles;
+    };
+
+    std::vector<int64_t> intervals;
+    std::vector<Series> series;
+    uint64_t fills = 0;
+    int64_t volume = 0;
+    int64_t notional = 0;
+    std::vector<TraderVolume> traders; // indexed by TraderId
+};
+
+#endif // TRADEANALYTICS_H
@@ -1,17 +1,55 @@
 #include "TraderBase.h"
 #include <iostream>
 #include <fstream>
-#include <algorithm>
+#include <mutex>
 
-void TraderBase::addTrader(const std::string& username) {
-    if (std::find(traders.begin(), traders.end(), username) == traders.end()) {
-        traders.push_back(username);
+// return the id of a trader, registering the name if it is new
+TraderId TraderBase::addTrader(std::string_view username) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = ids.find(username);
+        if (it != ids.end()) {
+            return it->second;
+        }
+    }
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    auto [it, inserted] = ids.try_emplace(std::string(username), static_cast<TraderId>(traders.size()));
+    if (inserted) {
+        traders.emplace_back(username);
+    }
+    return it->second;
+}
+
+bool TraderBase::findTrader(std::string_view username, TraderId& id) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto it = ids.find(username);
+    if (it == ids.end()) {
+        return false;
     }
+    id = it->second;
+    return true;
+}
+
+std::string TraderBase::getName(TraderId id) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return id < traders.size() ? traders[id] : std::string();
+}
+
+void TraderBase::reserve(size_t count) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    traders.reserve(traders.size() + count);
+    ids.reserve(ids.size() + count);
+}
+
+size_t TraderBase::getSize() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return traders.size();
 }
 
 void TraderBase::saveToFile(const std::string& filename) {
     std::ofstream file(filename);
     if(file.is_open()){
+        std::shared_lock<std::shared_mutex> lock(mutex);
         for (const auto& username : traders) {
             file << username << std::endl;
         }
@@ -27,7 +65,9 @@ void TraderBase::loadFromFile(const std::string& filename) {
     if(file.is_open()){
         std::string line;
         while (std::getline(file, line)) {
-            traders.push_back(line);
+            if (!line.empty()) {
+                addTrader(line);
+            }
         }
         file.close();
     }
@@ -35,4 +75,4 @@ void TraderBase::loadFromFile(const std::string& filename) {
         std::cerr << "Error opening a file: " << filename << std::endl;
     }
     
-}
\ No newline at end of file
+}
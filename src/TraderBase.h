@@ -1,17 +1,42 @@
 #ifndef TRADERBASE_H
 #define TRADERBASE_H
 
-#include <vector>
+#include <cstdint>
+#include <functional>
+#include <shared_mutex>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
+// compact trader handle; indexes TraderBase's name table
+using TraderId = uint32_t;
+
+// Interning registry of trader usernames. Every name is assigned a dense
+// integer id on first sight; orders and transactions carry the id and the
+// name is only looked up for display and persistence.
 class TraderBase {
 public:
-    void addTrader(const std::string& username);
+    TraderId addTrader(std::string_view username);
+    bool findTrader(std::string_view username, TraderId& id) const;
+    std::string getName(TraderId id) const;
+    size_t getSize() const;
+    // room for `count` more names, for bulk loading
+    void reserve(size_t count);
     void saveToFile(const std::string& filename);
     void loadFromFile(const std::string& filename);
 
 private:
-    std::vector<std::string> traders;
+    // allows lookups by std::string_view without building a std::string
+    struct NameHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view name) const { return std::hash<std::string_view>{}(name); }
+    };
+
+    // names are registered by the input thread and read by the others
+    mutable std::shared_mutex mutex;
+    std::vector<std::string> traders; // indexed by TraderId
+    std::unordered_map<std::string, TraderId, NameHash, std::equal_to<>> ids;
 };
 
-#endif // TRADERBASE_H
\ No newline at end of file
+#endif // TRADERBASE_H
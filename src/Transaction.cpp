@@ -1,37 +1,52 @@
 #include "Transaction.h"
-#include <sstream>
+#include "Tokenizer.h"
 #include <format>
 
-Transaction::Transaction(int quantity, double pricePerOne, time_t timestamp, const std::string& seller, const std::string& buyer)
-    : quantity(quantity), pricePerOne(pricePerOne), totalPrice(pricePerOne * quantity), date(timestamp), seller(seller), buyer(buyer) {}
+Transaction::Transaction(int quantity, Price pricePerOne, time_t timestamp, TraderId seller, TraderId buyer)
+    : quantity(quantity), pricePerOne(pricePerOne), date(timestamp), seller(seller), buyer(buyer) {}
     // - `quantity`: The number of items in the order.
-    // - `pricePerOne * quantity`: Sets the total price.
+    // - `pricePerOne`: The price of one item, in ticks.
     // - `date`: The timestamp for when the order was created.
-    // - `seller`: The username of a trader who placed sell order.
-    // - `buyer`: The username of a trader who placed buy order.
+    // - `seller`: The id of the trader who placed sell order.
+    // - `buyer`: The id of the trader who placed buy order.
 
-// serialize transaction for file writing
-std::string Transaction::serialize() const {
-    return std::format("{} {} {} {} {}", quantity, pricePerOne, date, seller, buyer);
+// serialize transaction for file writing (price in ticks, traders by name)
+std::string Transaction::serialize(const TraderBase& traderBase) const {
+    return std::format("{} {} {} {} {}", quantity, pricePerOne, date, traderBase.getName(seller), traderBase.getName(buyer));
 }
 
 // deserialize transaction loaded from a file
-std::unique_ptr<Transaction> Transaction::deserialize(const std::string& data) {
-    std::stringstream ss(data);
+std::optional<Transaction> Transaction::deserialize(std::string_view data, TraderBase& traderBase) {
+    Tokenizer tokens(data);
     int quantity;
-    double pricePerOne;
+    Price pricePerOne;
     time_t date;
-    std::string seller, buyer;
-    if (ss >> quantity >> pricePerOne >> date >> seller >> buyer) {
-        return std::make_unique<Transaction>(quantity, pricePerOne, date, seller, buyer);
+    std::string_view seller, buyer;
+    if (nextNumber(tokens, quantity) && nextNumber(tokens, pricePerOne) && nextNumber(tokens, date)
+        && tokens.next(seller) && tokens.next(buyer)) {
+        return Transaction(quantity, pricePerOne, date, traderBase.addTrader(seller), traderBase.addTrader(buyer));
     }
-    return nullptr;
+    return std::nullopt;
+}
+
+std::optional<Transaction> Transaction::deserializeDecimal(std::string_view data, TraderBase& traderBase) {
+    Tokenizer tokens(data);
+    int quantity;
+    std::string_view priceText;
+    Price pricePerOne;
+    time_t date;
+    std::string_view seller, buyer;
+    if (nextNumber(tokens, quantity) && tokens.next(priceText) && decimalPriceToTicks(priceText, pricePerOne)
+        && nextNumber(tokens, date) && tokens.next(seller) && tokens.next(buyer)) {
+        return Transaction(quantity, pricePerOne, date, traderBase.addTrader(seller), traderBase.addTrader(buyer));
+    }
+    return std::nullopt;
 }
 
 // getter functions for private attributes
-double Transaction::getPricePerOne() const { return pricePerOne; }
+Price Transaction::getPricePerOne() const { return pricePerOne; }
 time_t Transaction::getDate() const { return date; }
 int Transaction::getQuantity() const { return quantity; }
-std::string Transaction::getSeller() const { return seller; }
-std::string Transaction::getBuyer() const { return buyer; }
-double Transaction::getTotalPrice() const { return totalPrice; }
\ No newline at end of file
+TraderId Transaction::getSeller() const { return seller; }
+TraderId Transaction::getBuyer() const { return buyer; }
+Price Transaction::getTotalPrice() const { return pricePerOne * quantity; }
\ No newline at end of file
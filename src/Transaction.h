@@ -1,28 +1,32 @@
 #ifndef TRANSACTION_H
 #define TRANSACTION_H
 
+#include <optional>
 #include <string>
-#include <memory>
+#include "Price.h"
+#include "TraderBase.h"
 
+// a fill; small enough to be passed around by value
 class Transaction {
 public:
-    Transaction(int quantity, double pricePerOne, time_t timestamp, const std::string& seller, const std::string& buyer);
-    std::string serialize() const;
-    static std::unique_ptr<Transaction> deserialize(const std::string& data);
-    double getPricePerOne() const;
+    Transaction(int quantity, Price pricePerOne, time_t timestamp, TraderId seller, TraderId buyer);
+    std::string serialize(const TraderBase& traderBase) const;
+    static std::optional<Transaction> deserialize(std::string_view data, TraderBase& traderBase);
+    // a transaction of the first text format, which has a decimal price
+    static std::optional<Transaction> deserializeDecimal(std::string_view data, TraderBase& traderBase);
+    Price getPricePerOne() const;
     time_t getDate() const;
     int getQuantity() const;
-    std::string getSeller() const;
-    std::string getBuyer() const;
-    double getTotalPrice() const;
+    TraderId getSeller() const;
+    TraderId getBuyer() const;
+    Price getTotalPrice() const;
 
 private:
     int quantity;
-    double pricePerOne;
-    double totalPrice;
+    Price pricePerOne;
     time_t date;
-    std::string seller;
-    std::string buyer;
+    TraderId seller;
+    TraderId buyer;
 };
 
 #endif // TRANSACTION_H
\ No newline at end of file
@@ -1,51 +1,358 @@
 #include "TransactionList.h"
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 
-void TransactionList::addTransaction(std::unique_ptr<Transaction> tx) {
-    txList.push_back(std::move(tx));
+static void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+static uint64_t getVarint(const uint8_t*& in) {
+    uint64_t value = 0;
+    for (int shift = 0; ; shift += 7) {
+        uint8_t byte = *in++;
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return value;
+    }
+}
+
+// small negative deltas become small varints
+static uint64_t zigzag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+static int64_t unzigzag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+TransactionList::TransactionList(std::string spillFile, size_t memoryBlocks)
+    : memoryBlocks(memoryBlocks), spillFile(std::move(spillFile)) {}
+
+// the spill file only holds history that is also in the snapshot
+TransactionList::~TransactionList() {
+    {
+        std::lock_guard<std::mutex> lock(sealMutex);
+        stopping = true;
+    }
+    sealWake.notify_one();
+    if (sealer.joinable()) {
+        sealer.join();
+    }
+    if (spill) {
+        std::fclose(spill);
+        std::remove(spillFile.c_str());
+    }
+}
+
+void TransactionList::addTransaction(const Transaction& tx) {
+    appendTransaction(tx);
+    publishTransactions();
+}
+
+void TransactionList::appendTransaction(const Transaction& tx) {
+    size_t block = appended >> BLOCK_BITS;
+    size_t row = appended & (BLOCK_SIZE - 1);
+    if (row == 0 && block >= HOT_BLOCKS) {
+        // the ring block about to be reused must be sealed, and stops
+        // being readable, first
+        while (sealedBlocks.load(std::memory_order_acquire) <= block - HOT_BLOCKS) {
+            std::this_thread::yield();
+        }
+        hotStart.store((block - HOT_BLOCKS + 1) << BLOCK_BITS, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    } else if (row == 0 && !hot[block]) {
+        // ring blocks are allocated as the history first reaches them,
+        // unless reserve() did already; readers only look at published
+        // rows, which come after this
+        hot[block] = std::make_unique<HotBlock>();
+    }
+    HotBlock& columns = *hot[block % HOT_BLOCKS];
+    columns.pricePerOne[row].store(tx.getPricePerOne(), std::memory_order_relaxed);
+    columns.date[row].store(tx.getDate(), std::memory_order_relaxed);
+    columns.quantity[row].store(tx.getQuantity(), std::memory_order_relaxed);
+    columns.seller[row].store(tx.getSeller(), std::memory_order_relaxed);
+    columns.buyer[row].store(tx.getBuyer(), std::memory_order_relaxed);
+    ++appended;
+    if (row == BLOCK_SIZE - 1) {
+        handOver(block);
+    }
+}
+
+// the rows up to `appended` are written before this store,
+// so a reader that loads the count also sees them
+void TransactionList::publishTransactions() {
+    published.store(appended, std::memory_order_release);
 }
 
 int TransactionList::getSize() const {
-    return txList.size();
+    return published.load(std::memory_order_acquire);
 }
 
 // return latest n transactions
-std::vector<Transaction*> TransactionList::getLastN(int n) {
-    int txCounter = 0;
-    std::vector<Transaction*> ans;
-    ans.reserve(n);
-    for(auto it = txList.rbegin(); it != txList.rend() && n > 0; ++it, --n){
-        ans.push_back(it->get());
+std::vector<Transaction> TransactionList::getLastN(int n) const {
+    size_t size = published.load(std::memory_order_acquire);
+    size_t oldest = std::max(hotStart.load(std::memory_order_acquire), size - std::min<size_t>(std::max(n, 0), size));
+    std::vector<Transaction> ans;
+    if (oldest >= size) return ans;
+    ans.reserve(size - oldest);
+    for (size_t index = size; index > oldest; --index) {
+        ans.push_back(readHot(index - 1));
+    }
+    // the matching thread may have reused the oldest ring block meanwhile;
+    // drop whatever it could have overwritten
+    std::atomic_thread_fence(std::memory_order_acquire);
+    size_t readable = hotStart.load(std::memory_order_relaxed);
+    if (readable > oldest) {
+        ans.erase(ans.begin() + (size > readable ? size - readable : 0), ans.end());
     }
     return ans;
 }
 
-void TransactionList::saveToFile(const std::string& filename) {
+std::optional<Transaction> TransactionList::getTransaction(size_t index) const {
+    if (index >= hotStart.load(std::memory_order_relaxed)) {
+        return readHot(index);
+    }
+    std::vector<Transaction> rows;
+    if (!readBlock(index >> BLOCK_BITS, rows)) {
+        return std::nullopt;
+    }
+    return rows[index & (BLOCK_SIZE - 1)];
+}
+
+Transaction TransactionList::readHot(size_t index) const {
+    const HotBlock& columns = *hot[(index >> BLOCK_BITS) % HOT_BLOCKS];
+    size_t row = index & (BLOCK_SIZE - 1);
+    return Transaction(columns.quantity[row].load(std::memory_order_relaxed),
+                       columns.pricePerOne[row].load(std::memory_order_relaxed),
+                       columns.date[row].load(std::memory_order_relaxed),
+                       columns.seller[row].load(std::memory_order_relaxed),
+                       columns.buyer[row].load(std::memory_order_relaxed));
+}
+
+// the appended transactions of a block, from the ring while it is still
+// there, otherwise decoded from memory or the spill file; false, with no
+// rows, if the spill file cannot be read
+bool TransactionList::readBlock(size_t block, std::vector<Transaction>& rows) const {
+    rows.clear();
+    size_t first = block << BLOCK_BITS;
+    if (first >= hotStart.load(std::memory_order_relaxed)) {
+        for (size_t index = first; index < std::min(first + BLOCK_SIZE, appended); ++index) {
+            rows.push_back(readHot(index));
+        }
+        return true;
+    }
+
+    // blocks out of the ring are sealed already; copy the encoded bytes
+    // out under the lock and decode them after
+    std::vector<uint8_t> encoded;
+    {
+        std::lock_guard<std::mutex> lock(sealMutex);
+        const SealedBlock& sealedBlock = sealed[block];
+        if (!sealedBlock.data.empty()) {
+            encoded = sealedBlock.data;
+        } else {
+            encoded.resize(sealedBlock.size);
+            if (std::fseek(spill, static_cast<long>(sealedBlock.offset), SEEK_SET) != 0
+                || std::fread(encoded.data(), 1, encoded.size(), spill) != encoded.size()) {
+                std::cerr << "Error reading a file: " << spillFile << std::endl;
+                return false;
+            }
+        }
+    }
+    const uint8_t* in = encoded.data();
+
+    std::vector<int64_t> dates(BLOCK_SIZE), prices(BLOCK_SIZE);
+    int64_t previous = 0;
+    for (auto& date : dates) {
+        date = previous += unzigzag(getVarint(in));
+    }
+    previous = 0;
+    for (auto& price : prices) {
+        price = previous += unzigzag(getVarint(in));
+    }
+    std::vector<int> quantities(BLOCK_SIZE);
+    for (auto& quantity : quantities) {
+        quantity = static_cast<int>(getVarint(in));
+    }
+    std::vector<TraderId> sellers(BLOCK_SIZE);
+    for (auto& seller : sellers) {
+        seller = static_cast<TraderId>(getVarint(in));
+    }
+    rows.reserve(BLOCK_SIZE);
+    for (size_t row = 0; row < BLOCK_SIZE; ++row) {
+        rows.emplace_back(quantities[row], prices[row], dates[row], sellers[row], static_cast<TraderId>(getVarint(in)));
+    }
+    return true;
+}
+
+// hand a full block to the sealer thread, starting it with the first one
+void TransactionList::handOver(size_t block) {
+    {
+        std::lock_guard<std::mutex> lock(sealMutex);
+        fullBlocks = block + 1;
+        if (!sealer.joinable()) {
+            sealer = std::thread(&TransactionList::runSealer, this);
+        }
+    }
+    sealWake.notify_one();
+}
+
+// Seal the full blocks in order as they are handed over, then spill the
+// oldest sealed blocks while more than `memoryBlocks` are in memory. A
+// block is encoded without the lock: the matching thread does not reuse
+// its ring slot before `sealedBlocks` passes it.
+void TransactionList::runSealer() {
+    std::unique_lock<std::mutex> lock(sealMutex);
+    while (true) {
+        sealWake.wait(lock, [this] { return stopping || sealed.size() < fullBlocks; });
+        if (sealed.size() == fullBlocks) {
+            return;
+        }
+        size_t block = sealed.size();
+        lock.unlock();
+        std::vector<uint8_t> data = encodeBlock(block);
+        lock.lock();
+        SealedBlock& sealedBlock = sealed.emplace_back();
+        sealedBlock.size = static_cast<uint32_t>(data.size());
+        sealedBlock.data = std::move(data);
+        memoryBytes.add(sealedBlock.size);
+        sealedBlocks.store(block + 1, std::memory_order_release);
+
+        while (!spillFile.empty() && !spillFailed && sealed.size() - inMemory > memoryBlocks) {
+            spillFailed = !spillBlock(inMemory);
+        }
+    }
+}
+
+// Encode a full block column by column: timestamps and prices as deltas
+// from the previous fill (mostly zero or close to it), quantities and
+// trader ids as they are. Every value is a varint.
+std::vector<uint8_t> TransactionList::encodeBlock(size_t block) const {
+    const HotBlock& columns = *hot[block % HOT_BLOCKS];
+    std::vector<uint8_t> out;
+    out.reserve(BLOCK_SIZE * 8);
+    int64_t previous = 0;
+    for (const auto& date : columns.date) {
+        int64_t value = date.load(std::memory_order_relaxed);
+        putVarint(out, zigzag(value - previous));
+        previous = value;
+    }
+    previous = 0;
+    for (const auto& price : columns.pricePerOne) {
+        int64_t value = price.load(std::memory_order_relaxed);
+        putVarint(out, zigzag(value - previous));
+        previous = value;
+    }
+    for (const auto& quantity : columns.quantity) {
+        putVarint(out, static_cast<uint32_t>(quantity.load(std::memory_order_relaxed)));
+    }
+    for (const auto& seller : columns.seller) {
+        putVarint(out, seller.load(std::memory_order_relaxed));
+    }
+    for (const auto& buyer : columns.buyer) {
+        putVarint(out, buyer.load(std::memory_order_relaxed));
+    }
+    out.shrink_to_fit();
+    return out;
+}
+
+// Move a sealed block to the end of the spill file; false if the file
+// cannot be written, and the caller stops spilling. Sealer thread only.
+bool TransactionList::spillBlock(size_t block) {
+    if (!spill) {
+        spill = std::fopen(spillFile.c_str(), "w+b");
+        if (!spill) {
+            std::cerr << "Error opening a file: " << spillFile << std::endl;
+            return false;
+        }
+    }
+    SealedBlock& sealedBlock = sealed[block];
+    if (std::fseek(spill, static_cast<long>(spillSize), SEEK_SET) != 0
+        || std::fwrite(sealedBlock.data.data(), 1, sealedBlock.size, spill) != sealedBlock.size) {
+        std::cerr << "Error writing a file: " << spillFile << std::endl;
+        return false;
+    }
+    sealedBlock.offset = spillSize;
+    spillSize += sealedBlock.size;
+    std::vector<uint8_t>().swap(sealedBlock.data);
+    memoryBytes.set(memoryBytes.get() - sealedBlock.size);
+    spilledBytes.add(sealedBlock.size);
+    ++inMemory;
+    return true;
+}
+
+void TransactionList::reserve(size_t count) {
+    if (count > 0) {
+        // the whole ring too, so the first fills do not allocate and fault it in
+        for (auto& block : hot) {
+            if (!block) block = std::make_unique<HotBlock>();
+        }
+    }
+    std::lock_guard<std::mutex> lock(sealMutex);
+    sealed.reserve(sealed.size() + count / BLOCK_SIZE + 1);
+}
+
+void TransactionList::flush() {
+    while (sealedBlocks.load(std::memory_order_acquire) < (appended >> BLOCK_BITS)) {
+        std::this_thread::yield();
+    }
+    // the sealer spills under the same lock right after sealing
+    std::lock_guard<std::mutex> lock(sealMutex);
+}
+
+void TransactionList::saveToFile(const std::string& filename, const TraderBase& traderBase) {
     std::ofstream file(filename);
     if(file.is_open()){
-        for (const auto& tx : txList) {
-            file << tx->serialize() << std::endl;
-        }
+        file << textStorageHeader() << std::endl;
+        bool complete = forEachTransaction(0, [&](const Transaction& tx) {
+            file << tx.serialize(traderBase) << std::endl;
+        });
         file.close();
+        if (!complete) {
+            std::cerr << "Error writing a file: " << filename << std::endl;
+        }
     }
     else{
         std::cerr << "Error opening a file: " << filename << std::endl;
     }
 }
 
-void TransactionList::loadFromFile(const std::string& filename) {
+bool TransactionList::loadFromFile(const std::string& filename, TraderBase& traderBase) {
     std::ifstream file(filename);
     if(file.is_open()){
+        bool decimal;
+        if (!readTextStorageHeader(file, filename, decimal)) {
+            return false;
+        }
         std::string line;
+        size_t converted = 0;
         while (std::getline(file, line)) {
-            auto tx = Transaction::deserialize(line);
+            auto tx = decimal ? Transaction::deserializeDecimal(line, traderBase) : Transaction::deserialize(line, traderBase);
             if (tx) {
-                addTransaction(std::move(tx));
+                appendTransaction(*tx);
+                converted += decimal;
             }
         }
+        publishTransactions();
+        if (converted > 0) {
+            std::cerr << "Converted " << converted << " transactions of " << filename << " from decimal prices to ticks" << std::endl;
+        }
+        return true;
     }
     else{
         std::cerr << "Error opening a file: " << filename << std::endl;
+        return false;
     }
-}
\ No newline at end of file
+}
+
+uint64_t TransactionList::getMemoryBytes() const {
+    return memoryBytes.get();
+}
+
+uint64_t TransactionList::getSpilledBytes() const {
+    return spilledBytes.get();
+}
@@ -1,20 +1,150 @@
 #ifndef TRANSACTIONLIST_H
 #define TRANSACTIONLIST_H
 
-#include <vector>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Stats.h"
 #include "Transaction.h"
 
+// Transaction history of one symbol, in the order the fills happened.
+// Only the matching thread adds to it; any thread may read the latest
+// transactions without a lock.
+//
+// Transactions are stored by column in blocks of BLOCK_SIZE. The newest
+// HOT_BLOCKS blocks are kept uncompressed in a ring for txlist, allocated
+// a block at a time as the history grows into it. A block
+// is sealed once full: its columns are encoded as varints (timestamps and
+// prices as deltas from the previous fill) and kept in memory, and when
+// more than `memoryBlocks` sealed blocks are in memory the oldest ones are
+// written to the spill file and dropped. Memory use is therefore bounded
+// apart from a few bytes of index per block. Sealing and spilling run on
+// a thread of the list's own, started with the first full block; the
+// matching thread only hands full blocks over, and waits for the sealer
+// only if it falls a whole ring behind.
+//
+// Appended transactions become visible to readers together when
+// publishTransactions() advances the published count, so readers always
+// see all the fills of an order or none of them.
 class TransactionList {
 public:
-    void addTransaction(std::unique_ptr<Transaction> tx);
+    static constexpr int BLOCK_BITS = 12;
+    static constexpr size_t BLOCK_SIZE = size_t(1) << BLOCK_BITS;
+    static constexpr size_t HOT_BLOCKS = 4;
+    static constexpr size_t MEMORY_BLOCKS = 256;
+
+    // without a spill file every sealed block stays in memory
+    explicit TransactionList(std::string spillFile = "", size_t memoryBlocks = MEMORY_BLOCKS);
+    ~TransactionList();
+    TransactionList(const TransactionList&) = delete;
+    TransactionList& operator=(const TransactionList&) = delete;
+
+    // append a transaction and publish it
+    void addTransaction(const Transaction& tx);
+    // append a transaction without publishing it; readers see it
+    // after the next publishTransactions()
+    void appendTransaction(const Transaction& tx);
+    void publishTransactions();
+
+    // number of published transactions; safe to call from any thread
     int getSize() const;
-    std::vector<Transaction*> getLastN(int n);
-    void saveToFile(const std::string& filename);
-    void loadFromFile(const std::string& filename);
+    // the latest n published transactions, newest first; safe to call from
+    // any thread, but only returns those still in the uncompressed ring
+    // (at least (HOT_BLOCKS - 1) * BLOCK_SIZE)
+    std::vector<Transaction> getLastN(int n) const;
+
+    // The calls below read sealed blocks and the spill file, so they are
+    // for the matching thread, or any thread once it has stopped. Both
+    // fail if a spilled block cannot be read back.
+    // transactions in the order they happened, index 0 is the oldest
+    std::optional<Transaction> getTransaction(size_t index) const;
+    // call `visit(transaction)` for every published transaction from
+    // index `from` on, oldest first, decoding a block at a time; stops
+    // and returns false at a block that cannot be read
+    template <typename Visitor>
+    bool forEachTransaction(size_t from, Visitor&& visit) const {
+        size_t size = getSize();
+        std::vector<Transaction> rows;
+        for (size_t index = from; index < size; ) {
+            if (!readBlock(index >> BLOCK_BITS, rows)) {
+                return false;
+            }
+            for (size_t row = index & (BLOCK_SIZE - 1); row < rows.size() && index < size; ++row, ++index) {
+                visit(rows[row]);
+            }
+        }
+        return true;
+    }
+
+    // room in the block index for `count` more transactions, for bulk
+    // loading; with any count the ring blocks not allocated yet are too
+    void reserve(size_t count);
+    // wait until every full block is sealed, and spilled if over the limit
+    void flush();
+    // loading converts files of the first, decimal text format; false if
+    // the file cannot be read
+    void saveToFile(const std::string& filename, const TraderBase& traderBase);
+    bool loadFromFile(const std::string& filename, TraderBase& traderBase);
+
+    // bytes of sealed blocks kept in memory and in the spill file;
+    // safe to read from any thread
+    uint64_t getMemoryBytes() const;
+    uint64_t getSpilledBytes() const;
 
 private:
-    std::vector<std::unique_ptr<Transaction>> txList;
+    // uncompressed columns of one block; atomic so that readers may look
+    // at a block while the matching thread overwrites it with a newer one
+    struct HotBlock {
+        std::array<std::atomic<Price>, BLOCK_SIZE> pricePerOne;
+        std::array<std::atomic<time_t>, BLOCK_SIZE> date;
+        std::array<std::atomic<int>, BLOCK_SIZE> quantity;
+        std::array<std::atomic<TraderId>, BLOCK_SIZE> seller;
+        std::array<std::atomic<TraderId>, BLOCK_SIZE> buyer;
+    };
+
+    struct SealedBlock {
+        std::vector<uint8_t> data; // encoded columns; empty once spilled
+        uint64_t offset = 0;       // in the spill file
+        uint32_t size = 0;         // encoded size in bytes
+    };
+
+    Transaction readHot(size_t index) const;
+    bool readBlock(size_t block, std::vector<Transaction>& rows) const;
+    void handOver(size_t block);
+    void runSealer();
+    std::vector<uint8_t> encodeBlock(size_t block) const;
+    bool spillBlock(size_t block);
+
+    std::array<std::unique_ptr<HotBlock>, HOT_BLOCKS> hot; // allocated on first use
+    size_t memoryBlocks;
+    std::string spillFile;
+
+    // sealer thread; the fields below are guarded by `sealMutex`
+    std::thread sealer;
+    mutable std::mutex sealMutex;
+    std::condition_variable sealWake;
+    size_t fullBlocks = 0;           // handed over by the matching thread
+    bool stopping = false;
+    std::vector<SealedBlock> sealed; // block i holds transactions [i * BLOCK_SIZE, (i + 1) * BLOCK_SIZE)
+    size_t inMemory = 0;             // sealed blocks before this one are spilled
+    std::FILE* spill = nullptr;      // opened on the first spill
+    bool spillFailed = false;        // the spill file could not be written; blocks stay in memory
+    uint64_t spillSize = 0;
+    std::atomic<size_t> sealedBlocks{0}; // readable without the lock
+    StatCounter memoryBytes;
+    StatCounter spilledBytes;
+
+    size_t appended = 0; // written by the matching thread only
+    std::atomic<size_t> published{0};
+    // oldest transaction still in the ring; raised before a ring block is reused
+    std::atomic<size_t> hotStart{0};
 };
 
-#endif // TRANSACTIONLIST_H
\ No newline at end of file
+#endif // TRANSACTIONLIST_H
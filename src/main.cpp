@@ -2,203 +2,730 @@
 #include "OrderBook.h"
 #include "TransactionList.h"
 #include "CommandType.h"
+#include "CommandParser.h"
+#include "SpscQueue.h"
+#include "Journal.h"
+#include "Snapshot.h"
+#include "MarketDataPublisher.h"
+#include "Instrument.h"
+#include "MatchingEngine.h"
+#include "Stats.h"
+#include "Runtime.h"
+#include "Replay.h"
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <iomanip>
 #include <iostream>
 #include <fstream>
-#include <queue>
 #include <thread>
-#include <mutex>
-#include <condition_variable>
-#include <future>
 #include <sstream>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
 
-std::queue<std::string> messageQueue; // for communication between inputHandler and orderProcessor
-std::mutex queueMutex, fileMutex, txListMutex; // for synchronizing shared resources
-std::condition_variable queueCv; // to notify orderProcessor of a new message
-bool inputFinished = false; // indicates when input handling is complete
 int TXLIST_OUTPUT_SIZE = 5; // maximum size of txlist command output
+int TOP_OF_BOOK_RATE = 20; // maximum top orders file updates per second
+const std::string STORAGE_DIR = "../storage";
+const std::string DEFAULT_SYMBOL = "DEFAULT"; // kept directly in STORAGE_DIR
 
-// Update top orders via writing to a file
-void writeTopOrders(const std::string& filename, const std::string& topBuyOrder, const std::string& topSellOrder) {
-    std::lock_guard<std::mutex> lock(fileMutex);
-    std::ofstream file(filename, std::ios::trunc); // overwrite previous content
-    if (file.is_open()) {
-        file << "Top Buy Order: " << topBuyOrder << std::endl;
-        file << "Top Sell Order: " << topSellOrder << std::endl;
-        file.close();
+// engine configuration, set from the command line
+std::vector<std::string> SYMBOLS = {DEFAULT_SYMBOL}; // the first one is used when a command names none
+size_t SHARD_COUNT = 0; // 0: one per core, up to one per symbol
+bool PIN_SHARDS = false;
+std::vector<unsigned> SHARD_CPUS; // shard i runs on SHARD_CPUS[i % size]; empty: as PIN_SHARDS says
+int INPUT_CPU = -1;     // -1: not pinned
+int PUBLISHER_CPU = -1;
+size_t RESERVE_ORDERS = 0; // resting orders per symbol to allocate room for at startup
+size_t RESERVE_FILLS = 0;  // transactions per symbol to allocate room for at startup
+bool LOCK_MEMORY = false;
+WaitStrategy WAIT_STRATEGY = WaitStrategy::BLOCKING;
+size_t JOURNAL_BATCH = 256;
+std::chrono::microseconds JOURNAL_INTERVAL{1000};
+SelfTradePrevention SELF_TRADE = SelfTradePrevention::CANCEL_NEWEST;
+std::vector<int64_t> CANDLE_INTERVALS = {60, 300, 3600}; // seconds
+RiskLimits RISK_LIMITS; // per trader and symbol; none by default
+const size_t TRADER_HEADROOM = 4096; // traders the risk and analytics tables have room for beyond the stored ones
+const size_t RECOVERY_BATCH = 4096; // journaled commands matched at a time on recovery
+std::string REPLAY_FILE;     // read commands from this file instead of the console
+std::string REPLAY_LOG_FILE; // write the fills of the replay here
+
+// A matching thread and its inputs. Symbol `s` belongs to shard
+// shardOf(s, shardCount); the input thread is the only producer of the queue
+// and the shard's thread is the only one touching the books it owns,
+// so no locks are shared between shards.
+struct Shard {
+    size_t index = 0;
+    SpscQueue<Command, 65536> commandQueue; // parsed commands from inputHandler
+    Journal journal; // write-ahead log of the shard's symbols since the last save
+    ShardStats stats;
+    std::thread thread;
+};
+
+// Latency, queue and book statistics of the whole engine. Only reads
+// relaxed counters, so it can run while the shards are matching.
+void printStats(std::ostream& out, const std::vector<std::unique_ptr<Shard>>& shards,
+                const std::vector<std::unique_ptr<Instrument>>& instruments, const MarketDataPublisher& publisher) {
+    for (const auto& shard : shards) {
+        const ShardStats& stats = shard->stats;
+        out << "Shard " << shard->index << ": " << stats.commands.get() << " commands, "
+            << stats.rejected.get() << " rejected, queue depth " << shard->commandQueue.size()
+            << " (max " << stats.maxQueueDepth.get() << ")" << std::endl;
+        out << "  queued:     " << stats.queueLatency.summary() << std::endl;
+        out << "  matching:   " << stats.matchLatency.summary() << std::endl;
+        out << "  end to end: " << stats.endToEndLatency.summary() << std::endl;
+    }
+    for (const auto& instrument : instruments) {
+        out << "Symbol " << instrument->symbol << ": " << instrument->stats.fills.get() << " fills, "
+            << instrument->stats.restingOrders.get() << " resting orders, transaction history "
+            << instrument->txList.getMemoryBytes() / 1024 << " KiB in memory and "
+            << instrument->txList.getSpilledBytes() / 1024 << " KiB on disk" << std::endl;
+    }
+    out << "Top of book publishing: " << publisher.getPublishLatency().summary() << std::endl;
+    PageFaults faults = getPageFaults();
+    out << "Page faults: " << faults.minor << " minor, " << faults.major << " major" << std::endl;
+}
+
+// refresh the depth readers see; matching thread of the symbol only
+void publishDepth(Instrument& instrument) {
+    BookDepth depth;
+    instrument.orderBook.getDepth(depth);
+    instrument.depth.store(depth);
+}
+
+// Print the best `levels` price levels of both sides, side by side
+void printDepth(const Instrument& instrument, size_t levels) {
+    BookDepth depth;
+    instrument.depth.load(depth);
+    if (levels > BookDepth::LEVELS) {
+        std::cout << "Only the best " << BookDepth::LEVELS << " levels are available" << std::endl;
+        levels = BookDepth::LEVELS;
+    }
+    auto describe = [](const DepthLevel& level) {
+        return std::to_string(level.quantity) + " @ " + formatPrice(level.price) + " (" + std::to_string(level.orders) + " orders)";
+    };
+    size_t rows = std::min(levels, std::max(depth.buyLevels, depth.sellLevels));
+    if (rows == 0) {
+        std::cout << "No resting orders" << std::endl;
     }
-    else{
-        std::cerr << "Error opening a file: " << filename << std::endl;
+    for (size_t i = 0; i < rows; ++i) {
+        std::cout << "Buy: " << (i < depth.buyLevels ? describe(depth.buy[i]) : "-")
+                  << " | Sell: " << (i < depth.sellLevels ? describe(depth.sell[i]) : "-") << std::endl;
+    }
+}
+
+// Answer a candles, vwap, volume or position command from the symbol's
+// analytics and risk table; matching thread of the symbol only
+void printQuery(const Instrument& instrument, const Command& command, const TraderBase& traderBase) {
+    const TradeAnalytics& analytics = instrument.analytics;
+    if (command.type == CommandType::CANDLES) {
+        std::vector<Candle> candles;
+        if (!analytics.getCandles(command.pricePerOne, command.quantity, candles)) {
+            std::cout << "Candles are kept for:";
+            for (int64_t interval : analytics.getIntervals()) {
+                std::cout << ' ' << formatInterval(interval);
+            }
+            std::cout << std::endl;
+        } else if (candles.empty()) {
+            std::cout << "No available transactions!" << std::endl;
+        }
+        for (const Candle& candle : candles) {
+            std::cout << std::put_time(std::localtime(&candle.start), "%Y-%m-%d %H:%M:%S")
+                      << " | Open: " << formatPrice(candle.open) << " | High: " << formatPrice(candle.high)
+                      << " | Low: " << formatPrice(candle.low) << " | Close: " << formatPrice(candle.close)
+                      << " | Volume: " << candle.volume
+                      << " | VWAP: " << formatPrice(getVwap(candle.notional, candle.volume)) << std::endl;
+        }
+    } else if (command.type == CommandType::VWAP) {
+        if (analytics.getFills() == 0) {
+            std::cout << "No available transactions!" << std::endl;
+        } else {
+            std::cout << "VWAP: " << formatPrice(getVwap(analytics.getNotional(), analytics.getVolume()))
+                      << " | Volume: " << analytics.getVolume() << " | Fills: " << analytics.getFills() << std::endl;
+        }
+    } else if (command.type == CommandType::POSITION) {
+        TraderRisk risk = instrument.risk.getTraderRisk(command.trader);
+        std::cout << traderBase.getName(command.trader) << ": Position: " << risk.position
+                  << " | Open buy: " << risk.openBuy << " | Open sell: " << risk.openSell
+                  << " | Open notional: " << formatPrice(risk.openNotional) << std::endl;
+    } else {
+        TraderVolume volume = analytics.getTraderVolume(command.trader);
+        std::cout << traderBase.getName(command.trader) << " bought " << volume.bought
+                  << " and sold " << volume.sold << std::endl;
     }
 }
 
-// Thread function for handling user inputs
-void inputHandler(TraderBase& traderBase, OrderBook& orderBook, TransactionList& txList) {
-    std::string inputLine, type, username;
-    CommandType commandType;
-    double totalPrice;
-    int quantity;
+// symbol name -> id, looked up with the std::string_view of a parsed command
+struct SymbolHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view name) const { return std::hash<std::string_view>{}(name); }
+};
+using SymbolIds = std::unordered_map<std::string, SymbolId, SymbolHash, std::equal_to<>>;
+
+// Thread function for handling user inputs; routes every command to the
+// shard owning its symbol. The end of the input stops the engine like "exit".
+void inputHandler(std::istream& input, TraderBase& traderBase, std::vector<std::unique_ptr<Instrument>>& instruments,
+                  std::vector<std::unique_ptr<Shard>>& shards, const MarketDataPublisher& publisher) {
+    std::string inputLine;
+    ParsedCommand parsed;
+    int64_t receivedAt = 0;
+    SymbolIds symbolIds;
+    for (const auto& instrument : instruments) {
+        symbolIds.emplace(instrument->symbol, instrument->id);
+    }
+    auto route = [&shards, &parsed, &receivedAt](Command command) {
+        Shard& shard = *shards[shardOf(command.symbol, shards.size())];
+        command.receivedAt = receivedAt;
+        shard.commandQueue.push(command);
+        shard.stats.maxQueueDepth.raise(shard.commandQueue.size());
+    };
     while (true) {
         // prompt for user input
         std::cout << "> ";
-        std::getline(std::cin, inputLine);
-        std::stringstream ss(inputLine);
-        if (inputLine.empty()) continue;
-        ss >> type;
-        try {
-            commandType = getOrderTypeFromString(type); // convert input string to CommandType
-        }
-        catch (std::invalid_argument& e) {
-            std::cerr << e.what() << std::endl;
-            continue;
+        if (!std::getline(input, inputLine)) {
+            parsed.type = CommandType::EXIT;
+        } else {
+            receivedAt = steadyNanoseconds();
+            ParseError error = parseCommand(inputLine, parsed);
+            if (error == ParseError::EMPTY) continue;
+            if (error != ParseError::NONE) {
+                std::cout << describeParseError(error, parsed) << std::endl;
+                continue;
+            }
         }
-        if (commandType == CommandType::EXIT) {
-            inputFinished = true;
-            queueCv.notify_one(); // notify orderProcessor thread to exit
+        if (parsed.type == CommandType::EXIT) {
+            for (auto& shard : shards) {
+                shard->commandQueue.push(Command{.type = CommandType::EXIT}); // notify every shard to exit
+            }
             std::cout << "Input thread has finished" << std::endl;
             break;
         }
-        if (commandType == CommandType::TXLIST) {
-            int txListSize = txList.getSize();
-            if (txListSize) {
-                int outputSize = std::min(TXLIST_OUTPUT_SIZE, txListSize); 
-                std::unique_lock<std::mutex> lock(txListMutex);
-                std::vector<Transaction*> txArr = txList.getLastN(outputSize);
-                txListMutex.unlock(); // unlock after retrieving transactions
-                for (auto tx: txArr) {
-                    auto txDate = tx->getDate();
-                    std::cout << "Quantity: " << tx->getQuantity()
-                              << " | Total Price: " << tx->getTotalPrice()
+        if (parsed.type == CommandType::STATS) {
+            printStats(std::cout, shards, instruments, publisher);
+            continue;
+        }
+
+        // without "@SYMBOL" the command is for the first symbol
+        SymbolId symbol = 0;
+        if (!parsed.symbol.empty()) {
+            auto it = symbolIds.find(parsed.symbol);
+            if (it == symbolIds.end()) {
+                std::cout << "Unknown symbol: " << parsed.symbol << std::endl;
+                continue;
+            }
+            symbol = it->second;
+        }
+        Instrument& instrument = *instruments[symbol];
+        if (parsed.type == CommandType::TXLIST) {
+            std::vector<Transaction> txArr = instrument.txList.getLastN(TXLIST_OUTPUT_SIZE);
+            if (!txArr.empty()) {
+                for (const auto& tx: txArr) {
+                    auto txDate = tx.getDate();
+                    std::cout << "Quantity: " << tx.getQuantity()
+                              << " | Total Price: " << formatPrice(tx.getTotalPrice())
                               << " | Date: " << std::ctime(&txDate)
-                              << " | Buyer: " << tx->getBuyer()
-                              << " | Seller: " << tx->getSeller() << std::endl;
+                              << " | Buyer: " << traderBase.getName(tx.getBuyer())
+                              << " | Seller: " << traderBase.getName(tx.getSeller()) << std::endl;
                 }
             } else {
                 std::cout << "No available transactions!" << std::endl;
             }
-        } else {
-            if (!(ss >> username >> totalPrice >> quantity)) {
-                std::cout << "Error: Invalid input. Please provide your username, totalPrice and quantity to create order" << std::endl;
+        } else if (parsed.type == CommandType::DEPTH) {
+            printDepth(instrument, parsed.levels);
+        } else if (parsed.type == CommandType::CANDLES) {
+            route(Command{.type = parsed.type, .quantity = parsed.levels, .pricePerOne = parsed.interval, .symbol = symbol});
+        } else if (parsed.type == CommandType::VWAP) {
+            route(Command{.type = parsed.type, .symbol = symbol});
+        } else if (parsed.type == CommandType::VOLUME || parsed.type == CommandType::POSITION) {
+            TraderId trader;
+            if (!traderBase.findTrader(parsed.trader, trader)) {
+                std::cout << "Unknown trader: " << parsed.trader << std::endl;
                 continue;
             }
-            if (quantity <= 0) {
-                std::cout << "Quantity must be greater than 0." << std::endl;
+            route(Command{.type = parsed.type, .trader = trader, .symbol = symbol});
+        } else if (parsed.type == CommandType::CANCEL || parsed.type == CommandType::AMEND) {
+            // only the trader owning the order may change it; the engine checks
+            TraderId trader;
+            if (!traderBase.findTrader(parsed.trader, trader)) {
+                std::cout << "Unknown trader: " << parsed.trader << std::endl;
                 continue;
             }
-            if (totalPrice <= 0) {
-                std::cout << "Total Price must be greater than 0." << std::endl;
-                continue;
-            }
-            traderBase.addTrader(username); // ensure trader is registered
-            std::lock_guard<std::mutex> lock(queueMutex);
-            messageQueue.push(inputLine);
-            queueCv.notify_one(); // notify orderProcessor of a new message
+            route(Command{.type = parsed.type, .orderId = parsed.orderId, .trader = trader, .quantity = parsed.quantity, .symbol = symbol});
+        } else {
+            TraderId trader = traderBase.addTrader(parsed.trader); // ensure trader is registered
+            OrderId orderId = ++instrument.lastOrderId; // order ids are assigned per symbol
+            route(Command{parsed.type, orderId, trader, parsed.quantity, parsed.pricePerOne, parsed.orderType, symbol, SELF_TRADE});
+            std::cout << "Order ID: " << orderId << std::endl;
         }
     }
 }
 
-// Thread function for processing orders
-void processor(TraderBase& traderBase, OrderBook& orderBook, TransactionList& txList) {
-    std::vector<std::future<void>> futures; // store futures for async tasks
+// Thread function of a shard: processes the orders of the symbols it owns
+void processor(Shard& shard, std::vector<std::unique_ptr<Instrument>>& instruments, MarketDataPublisher& publisher,
+               const TraderBase& traderBase) {
     while (true) {
-        double totalPrice;
-        int quantity;
-        std::string type, username;
-        CommandType commandType;
-
-        std::unique_lock<std::mutex> lockMsgQueue(queueMutex);
-        // wait for new messages or input completion
-        queueCv.wait(lockMsgQueue, [] { return !messageQueue.empty() || inputFinished; }); 
-
-        if (inputFinished && messageQueue.empty()) {
-            // exit when input is finished and no messages remain
-            std::cout << "Processor has finished" << std::endl;
+        Command command;
+        shard.commandQueue.pop(command); // wait for the next command
+
+        if (command.type == CommandType::EXIT) {
+            // commands are processed in order, so nothing remains queued
+            std::cout << "Processor " << shard.index << " has finished" << std::endl;
             break;
         }
 
-        std::string message = messageQueue.front();
-        messageQueue.pop();
-        lockMsgQueue.unlock();
+        Instrument& instrument = *instruments[command.symbol];
+        // queries are answered here, in order with the commands before them
+        if (command.type == CommandType::CANDLES || command.type == CommandType::VWAP
+            || command.type == CommandType::VOLUME || command.type == CommandType::POSITION) {
+            printQuery(instrument, command, traderBase);
+            continue;
+        }
+        int64_t dequeuedAt = steadyNanoseconds();
+        // time when the command was processed
+        time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        SubmitResult result = instrument.engine.submit(command, now, &shard.journal);
+        int64_t matchedAt = steadyNanoseconds();
 
-        // time when order arrived and was processed
-        auto now = std::chrono::system_clock::now();
-        time_t timestamp = std::chrono::system_clock::to_time_t(now);
+        shard.stats.queueLatency.record(dequeuedAt - command.receivedAt);
+        shard.stats.matchLatency.record(matchedAt - dequeuedAt);
+        shard.stats.endToEndLatency.record(matchedAt - command.receivedAt);
+        shard.stats.commands.add();
+        if (result.status != CommandStatus::DONE) shard.stats.rejected.add();
+        instrument.stats.fills.add(result.fills.size());
+        instrument.stats.restingOrders.set(instrument.orderBook.getOrderPoolStats().live);
+        publishDepth(instrument);
 
-        std::stringstream ss(message);
-        ss >> type;
-        commandType = getOrderTypeFromString(type);
-        ss >> username >> totalPrice >> quantity;
+        switch (result.status) {
+            case CommandStatus::ORDER_NOT_FOUND:
+                std::cout << "Order " << command.orderId << " is not resting in the book" << std::endl;
+                break;
+            case CommandStatus::NOT_ORDER_OWNER:
+                std::cout << "Order " << command.orderId << " rejected: it belongs to another trader" << std::endl;
+                break;
+            case CommandStatus::POST_ONLY_WOULD_MATCH:
+                std::cout << "Order " << command.orderId << " rejected: post-only order would match" << std::endl;
+                break;
+            case CommandStatus::NOT_ENOUGH_QUANTITY:
+                std::cout << "Order " << command.orderId << " killed: not enough quantity to fill" << std::endl;
+                break;
+            case CommandStatus::SELF_TRADE_CANCELLED:
+                std::cout << "Order " << command.orderId << " cancelled: it would trade with its own trader" << std::endl;
+                break;
+            case CommandStatus::RISK_LIMIT_EXCEEDED:
+                std::cout << "Order " << command.orderId << " rejected: it would exceed a risk limit" << std::endl;
+                break;
+            default:
+                break;
+        }
 
-        // create and add a new order
-        auto newOrder = std::make_unique<Order>(quantity, totalPrice, timestamp, username);
-        if (commandType == CommandType::BUY) {
-            orderBook.addBuyOrder(std::move(newOrder));
+        // hand the top buy and sell orders to the publisher thread
+        publisher.publish(instrument.topOfBook, instrument.orderBook.getFrontBuyOrder(), instrument.orderBook.getFrontSellOrder());
+    }
+}
+
+// journal files of all shards, including those of runs with other shard counts
+std::vector<std::filesystem::path> findJournals() {
+    std::vector<std::filesystem::path> journals;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(STORAGE_DIR, error)) {
+        std::string name = entry.path().filename().string();
+        if (name.starts_with("journal") && name.ends_with(".bin")) {
+            journals.push_back(entry.path());
+        }
+    }
+    std::sort(journals.begin(), journals.end());
+    return journals;
+}
+
+// a CPU number: digits only
+bool parseCpu(const std::string& text, int& cpu) {
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), cpu);
+    if (text.empty() || error != std::errc() || end != text.data() + text.size() || cpu < 0) {
+        std::cerr << "Invalid CPU: \"" << text << "\"" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Parse command line options:
+//   --price-scale N        number of decimal places of the smallest price unit
+//   --tick-size N          minimum price increment, in smallest price units
+//   --symbols A,B,...      symbols to trade; commands without "@SYMBOL" go to
+//                          the first one (default: DEFAULT)
+//   --shards N             matching threads; each owns every N-th symbol
+//                          (default: one per core, at most one per symbol)
+//   --pin-shards           pin matching thread i to CPU i + 1
+//   --shard-cpus LIST      pin matching thread i to the i-th CPU of LIST, e.g. 2,3
+//   --input-cpu N          pin the input thread to CPU N
+//   --publisher-cpu N      pin the top of book publisher thread to CPU N
+//   --wait-strategy NAME   how the processors wait for commands:
+//                          busy-spin, spin-yield or blocking (default);
+//                          busy-spin never sleeps, so it wants a CPU of its own
+//   --reserve-orders N     allocate room for N more resting orders per symbol
+//                          at startup, so the order pool and index do not grow,
+//                          and the price levels around the best prices
+//   --reserve-fills N      ... and for N more transactions per symbol
+//   --lock-memory          lock all memory in RAM (mlockall), faulting it in
+//                          when allocated; needs a large enough memlock limit
+//   --journal-batch N      fsync the journal at least every N records
+//   --journal-interval-us N  ... and at least every N microseconds
+//   --top-of-book-rate N   update the top orders files at most N times a second
+//   --self-trade POLICY    when an order meets a resting order of its own trader:
+//                          cancel-newest (default), cancel-oldest, cancel-both
+//                          or decrement
+//   --max-position N       reject orders that could take a trader's net position
+//                          on a symbol beyond N either way
+//   --max-open-quantity N  ... or their resting quantity on a symbol beyond N
+//   --max-open-notional P  ... or the value of their resting orders beyond P
+//   --candle-intervals LIST  candle intervals kept per symbol, e.g. 30s,1m,1h
+//                          (default: 1m,5m,1h)
+//   --replay FILE          match the commands of FILE ("<timestamp> <command>"
+//                          per line) at full speed from empty books, report the
+//                          throughput and exit; the storage is neither read nor
+//                          written, so every replay of FILE gives the same fills
+//   --replay-log FILE      after a replay, write the fills it produced to FILE
+bool parseArguments(int argc, char* argv[]) {
+    PriceConfig priceConfig;
+    long long journalIntervalUs = JOURNAL_INTERVAL.count();
+    const char* maxOpenNotional = nullptr; // parsed once the price scale is known
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--price-scale") == 0 && i + 1 < argc) {
+            priceConfig.scale = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--tick-size") == 0 && i + 1 < argc) {
+            priceConfig.tickSize = std::atoll(argv[++i]);
+        } else if (std::strcmp(argv[i], "--symbols") == 0 && i + 1 < argc) {
+            SYMBOLS.clear();
+            std::stringstream list(argv[++i]);
+            std::string symbol;
+            while (std::getline(list, symbol, ',')) {
+                if (symbol.empty() || std::find(SYMBOLS.begin(), SYMBOLS.end(), symbol) != SYMBOLS.end()
+                    || symbol.find_first_of("/\\.") != std::string::npos) {
+                    std::cerr << "Invalid or repeated symbol: \"" << symbol << "\"" << std::endl;
+                    return false;
+                }
+                SYMBOLS.push_back(symbol);
+            }
+            if (SYMBOLS.empty()) {
+                std::cerr << "At least one symbol is required" << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(argv[i], "--shards") == 0 && i + 1 < argc) {
+            int shards = std::atoi(argv[++i]);
+            if (shards <= 0) {
+                std::cerr << "Shard count must be greater than 0" << std::endl;
+                return false;
+            }
+            SHARD_COUNT = shards;
+        } else if (std::strcmp(argv[i], "--pin-shards") == 0) {
+            PIN_SHARDS = true;
+        } else if (std::strcmp(argv[i], "--shard-cpus") == 0 && i + 1 < argc) {
+            SHARD_CPUS.clear();
+            std::stringstream list(argv[++i]);
+            std::string text;
+            while (std::getline(list, text, ',')) {
+                int cpu;
+                if (!parseCpu(text, cpu)) {
+                    return false;
+                }
+                SHARD_CPUS.push_back(cpu);
+            }
+        } else if (std::strcmp(argv[i], "--input-cpu") == 0 && i + 1 < argc) {
+            if (!parseCpu(argv[++i], INPUT_CPU)) {
+                return false;
+            }
+        } else if (std::strcmp(argv[i], "--publisher-cpu") == 0 && i + 1 < argc) {
+            if (!parseCpu(argv[++i], PUBLISHER_CPU)) {
+                return false;
+            }
+        } else if (std::strcmp(argv[i], "--wait-strategy") == 0 && i + 1 < argc) {
+            std::string name = argv[++i];
+            if (name == "busy-spin") {
+                WAIT_STRATEGY = WaitStrategy::BUSY_SPIN;
+            } else if (name == "spin-yield") {
+                WAIT_STRATEGY = WaitStrategy::SPIN_YIELD;
+            } else if (name == "blocking") {
+                WAIT_STRATEGY = WaitStrategy::BLOCKING;
+            } else {
+                std::cerr << "Unknown wait strategy: " << name << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(argv[i], "--top-of-book-rate") == 0 && i + 1 < argc) {
+            TOP_OF_BOOK_RATE = std::atoi(argv[++i]);
+            if (TOP_OF_BOOK_RATE <= 0) {
+                std::cerr << "Top of book rate must be greater than 0" << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(argv[i], "--self-trade") == 0 && i + 1 < argc) {
+            if (!parseSelfTradePrevention(argv[++i], SELF_TRADE)) {
+                std::cerr << "Unknown self-trade prevention policy: " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(argv[i], "--max-position") == 0 && i + 1 < argc) {
+            RISK_LIMITS.maxPosition = std::max(0LL, std::atoll(argv[++i]));
+        } else if (std::strcmp(argv[i], "--max-open-quantity") == 0 && i + 1 < argc) {
+            RISK_LIMITS.maxOpenQuantity = std::max(0LL, std::atoll(argv[++i]));
+        } else if (std::strcmp(argv[i], "--max-open-notional") == 0 && i + 1 < argc) {
+            maxOpenNotional = argv[++i];
+        } else if (std::strcmp(argv[i], "--candle-intervals") == 0 && i + 1 < argc) {
+            CANDLE_INTERVALS.clear();
+            std::stringstream list(argv[++i]);
+            std::string text;
+            while (std::getline(list, text, ',')) {
+                int64_t interval;
+                if (!parseInterval(text, interval)) {
+                    std::cerr << "Invalid candle interval: \"" << text << "\"" << std::endl;
+                    return false;
+                }
+                CANDLE_INTERVALS.push_back(interval);
+            }
+        } else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            REPLAY_FILE = argv[++i];
+        } else if (std::strcmp(argv[i], "--replay-log") == 0 && i + 1 < argc) {
+            REPLAY_LOG_FILE = argv[++i];
+        } else if (std::strcmp(argv[i], "--reserve-orders") == 0 && i + 1 < argc) {
+            RESERVE_ORDERS = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--reserve-fills") == 0 && i + 1 < argc) {
+            RESERVE_FILLS = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--lock-memory") == 0) {
+            LOCK_MEMORY = true;
+        } else if (std::strcmp(argv[i], "--journal-batch") == 0 && i + 1 < argc) {
+            JOURNAL_BATCH = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--journal-interval-us") == 0 && i + 1 < argc) {
+            journalIntervalUs = std::atoll(argv[++i]);
         } else {
-            orderBook.addSellOrder(std::move(newOrder));
-        }
-
-        // match orders in the order book
-        while (orderBook.getFrontSellOrder() && orderBook.getFrontBuyOrder()
-            && orderBook.getFrontSellOrder()->getPricePerOne() <= orderBook.getFrontBuyOrder()->getPricePerOne()
-            && orderBook.getFrontSellOrder()->getTrader() != orderBook.getFrontBuyOrder()->getTrader()) {
-            Order* minSellOrder = orderBook.getFrontSellOrder();
-            Order* maxBuyOrder = orderBook.getFrontBuyOrder();
-            std::unique_lock<std::mutex> lockTxList(txListMutex, std::defer_lock); // defer locking until needed
-            auto res = minSellOrder->getQuantity() <=> maxBuyOrder->getQuantity();
-            if (res == 0) { // quantities match
-                auto tx = std::make_unique<Transaction>(minSellOrder->getQuantity(), minSellOrder->getPricePerOne(), timestamp, minSellOrder->getTrader(), maxBuyOrder->getTrader());
-                lockTxList.lock();
-                txList.addTransaction(std::move(tx));
-                lockTxList.unlock();
-                orderBook.popBuyOrder();
-                orderBook.popSellOrder();
-            } 
-            else if (res > 0) { // sell order has higher quantity
-                auto tx = std::make_unique<Transaction>(maxBuyOrder->getQuantity(), minSellOrder->getPricePerOne(), timestamp, minSellOrder->getTrader(), maxBuyOrder->getTrader());
-                lockTxList.lock();
-                txList.addTransaction(std::move(tx));
-                lockTxList.unlock();
-                minSellOrder->changeQuantity(maxBuyOrder->getQuantity());
-                orderBook.popBuyOrder();
-            } 
-            else { // buy order has higher quantity
-                auto tx = std::make_unique<Transaction>(minSellOrder->getQuantity(), minSellOrder->getPricePerOne(), timestamp, minSellOrder->getTrader(), maxBuyOrder->getTrader());
-                lockTxList.lock();
-                txList.addTransaction(std::move(tx));
-                lockTxList.unlock();
-                maxBuyOrder->changeQuantity(minSellOrder->getQuantity());
-                orderBook.popSellOrder();
-            }
-        }
-
-        // update top buy and sell orders asynchronously
-        Order* topBuyOrder = orderBook.getFrontBuyOrder();
-        Order* topSellOrder = orderBook.getFrontSellOrder();
-        std::string topBuyOrderStr = topBuyOrder ? topBuyOrder->serialize() : "No Buy Orders";
-        std::string topSellOrderStr = topSellOrder ? topSellOrder->serialize() : "No Sell Orders";
-        futures.push_back(std::async(std::launch::async, writeTopOrders, "../storage/topOrders.txt", topBuyOrderStr, topSellOrderStr));
+            std::cerr << "Unknown argument: " << argv[i] << std::endl;
+            return false;
+        }
+    }
+    if (!setPriceConfig(priceConfig)) {
+        std::cerr << "Invalid price configuration: scale must be 0-9 and tick size positive" << std::endl;
+        return false;
+    }
+    if (maxOpenNotional) {
+        int64_t units;
+        if (!parsePriceUnits(maxOpenNotional, units) || units < 0) {
+            std::cerr << "Invalid notional limit: " << maxOpenNotional << std::endl;
+            return false;
+        }
+        RISK_LIMITS.maxOpenNotional = units / getPriceConfig().tickSize;
+    }
+    if (JOURNAL_BATCH == 0 || journalIntervalUs < 0) {
+        std::cerr << "Invalid journal configuration: batch must be positive and interval non-negative" << std::endl;
+        return false;
+    }
+    JOURNAL_INTERVAL = std::chrono::microseconds(journalIntervalUs);
+    if (!REPLAY_LOG_FILE.empty() && REPLAY_FILE.empty()) {
+        std::cerr << "--replay-log requires --replay" << std::endl;
+        return false;
+    }
+    if (SHARD_COUNT == 0) {
+        unsigned cores = std::max(std::thread::hardware_concurrency(), 2u);
+        SHARD_COUNT = cores - 1; // leave a core for the input thread
     }
+    SHARD_COUNT = std::min(SHARD_COUNT, SYMBOLS.size());
+    return true;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    if (!parseArguments(argc, argv)) {
+        return 1;
+    }
+
+    // a replay runs on its own, from empty books, and leaves the storage alone
+    if (!REPLAY_FILE.empty()) {
+        std::ifstream replayFile(REPLAY_FILE);
+        if (!replayFile.is_open()) {
+            std::cerr << "Error opening a file: " << REPLAY_FILE << std::endl;
+            return 1;
+        }
+        Replay replay(SYMBOLS, SELF_TRADE, RISK_LIMITS);
+        auto started = std::chrono::steady_clock::now();
+        replay.run(replayFile);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - started;
+        std::cout << "Replayed " << replay.getCommands() << " commands (" << replay.getRejected() << " rejected) in "
+                  << elapsed.count() << " s (" << static_cast<uint64_t>(replay.getCommands() / std::max(elapsed.count(), 1e-9))
+                  << " commands/s)" << std::endl;
+        if (!REPLAY_LOG_FILE.empty()) {
+            std::ofstream log(REPLAY_LOG_FILE);
+            if (!log.is_open()) {
+                std::cerr << "Error opening a file: " << REPLAY_LOG_FILE << std::endl;
+                return 1;
+            }
+            if (!replay.writeLog(log)) {
+                std::cerr << "Error writing a file: " << REPLAY_LOG_FILE << std::endl;
+                return 1;
+            }
+        }
+        return 0;
+    }
+
     TraderBase traderBase;
-    OrderBook orderBook;
-    TransactionList txList;
+    std::vector<std::unique_ptr<Instrument>> instruments;
 
-    // load data from storage
-    traderBase.loadFromFile("../storage/traders.txt");
-    orderBook.loadFromFile("../storage/orders.txt");
-    txList.loadFromFile("../storage/transactions.txt");
+    // load data from storage; the default symbol lives in the storage
+    // directory itself, every other one in a directory of its own. The text
+    // files are only read until the first binary snapshot has been written.
+    for (SymbolId id = 0; id < SYMBOLS.size(); ++id) {
+        std::string directory = SYMBOLS[id] == DEFAULT_SYMBOL ? STORAGE_DIR : STORAGE_DIR + "/" + SYMBOLS[id];
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        auto instrument = std::make_unique<Instrument>(id, SYMBOLS[id], directory);
+        if (instrument->snapshot.exists()) {
+            uint64_t journalSequence = 0;
+            if (!instrument->snapshot.load(traderBase, instrument->orderBook, instrument->txList, instrument->lastOrderId,
+                                           journalSequence)) {
+                return 1;
+            }
+            instrument->engine.setJournalSequence(journalSequence);
+        } else if (std::filesystem::exists(directory + "/orders.txt", error)) {
+            traderBase.loadFromFile(directory + "/traders.txt");
+            // a book without any trades yet may have no transactions file
+            if (!instrument->orderBook.loadFromFile(directory + "/orders.txt", traderBase)
+                || (std::filesystem::exists(directory + "/transactions.txt", error)
+                    && !instrument->txList.loadFromFile(directory + "/transactions.txt", traderBase))) {
+                return 1;
+            }
+            instrument->lastOrderId = instrument->orderBook.getLastOrderId();
+        }
+        // the analytics and the risk table are rebuilt once from the stored
+        // book and history and kept up to date by the engine from then on
+        instrument->orderBook.reserve(RESERVE_ORDERS);
+        instrument->txList.reserve(RESERVE_FILLS);
+        instrument->analytics.setIntervals(CANDLE_INTERVALS);
+        instrument->risk.setLimits(RISK_LIMITS);
+        instrument->risk.reserve(traderBase.getSize() + TRADER_HEADROOM);
+        instrument->analytics.reserve(traderBase.getSize() + TRADER_HEADROOM);
+        bool complete = instrument->txList.forEachTransaction(0, [&](const Transaction& tx) {
+            instrument->analytics.addFill(tx);
+            instrument->risk.filled(tx.getBuyer(), tx.getSeller(), tx.getQuantity());
+        });
+        if (!complete) {
+            return 1;
+        }
+        instrument->orderBook.forEachOrder([&](CommandType side, const Order& order) {
+            instrument->risk.orderAdded(order.getTrader(), side == CommandType::BUY, order.getQuantity(), order.getPricePerOne());
+        });
+        instruments.push_back(std::move(instrument));
+    }
 
-    // start input and processor threads
-    std::thread inputThread(inputHandler, std::ref(traderBase), std::ref(orderBook), std::ref(txList));
-    std::thread processingThread(processor, std::ref(traderBase), std::ref(orderBook), std::ref(txList));
+    // re-apply whatever happened after the last save, then save right away
+    // so the journals can start afresh with the current shard layout
+    // journaled commands are collected per symbol and matched in batches of
+    // RECOVERY_BATCH, so the engine's fill buffer stays the size of a batch;
+    // they passed the risk check when journaled, so it is not made again.
+    // Records a snapshot already includes are skipped: a crash after saving
+    // the snapshots but before removing the journals must not apply them twice
+    size_t replayed = 0;
+    std::vector<std::vector<Command>> recovered(instruments.size());
+    std::vector<std::filesystem::path> journals = findJournals();
+    for (const auto& path : journals) {
+        Journal::replay(path.string(), traderBase, SYMBOLS, [&](const JournalRecord& record) {
+            Instrument& instrument = *instruments[record.symbol];
+            if (record.sequence != 0) {
+                if (record.sequence <= instrument.engine.getJournalSequence()) return;
+                instrument.engine.setJournalSequence(record.sequence);
+            }
+            if (record.type == JournalRecordType::ORDER) {
+                instrument.lastOrderId = std::max<OrderId>(instrument.lastOrderId, record.orderId);
+            }
+            Command command = commandFromRecord(record);
+            command.timestamp = record.timestamp;
+            recovered[record.symbol].push_back(command);
+            ++replayed;
+        });
+    }
+    std::vector<CommandStatus> statuses(RECOVERY_BATCH);
+    for (auto& instrument : instruments) {
+        std::span<const Command> commands = recovered[instrument->id];
+        for (size_t i = 0; i < commands.size(); i += RECOVERY_BATCH) {
+            std::span<const Command> batch = commands.subspan(i, std::min(RECOVERY_BATCH, commands.size() - i));
+            instrument->engine.submitMany(batch, 0, statuses, nullptr, false);
+        }
+        recovered[instrument->id] = {};
+    }
+    if (replayed > 0) {
+        for (auto& instrument : instruments) {
+            if (!instrument->snapshot.save(traderBase, instrument->orderBook, instrument->txList, instrument->lastOrderId,
+                                           instrument->engine.getJournalSequence())) {
+                return 1;
+            }
+        }
+    }
+    for (const auto& path : journals) {
+        std::error_code error;
+        std::filesystem::remove(path, error);
+    }
+
+    for (auto& instrument : instruments) {
+        instrument->stats.restingOrders.set(instrument->orderBook.getOrderPoolStats().live);
+        publishDepth(*instrument);
+    }
+
+    // everything allocated so far stays resident, and later allocations
+    // (shard queues, pool growth) are faulted in when made, not when matching
+    if (LOCK_MEMORY) {
+        lockMemory();
+    }
+
+    MarketDataPublisher publisher(traderBase);
+    publisher.setMaxRate(TOP_OF_BOOK_RATE);
+    for (auto& instrument : instruments) {
+        instrument->topOfBook = publisher.addBook(instrument->directory + "/topOrders.txt");
+    }
+    publisher.start();
+    if (PUBLISHER_CPU >= 0) {
+        publisher.pin(PUBLISHER_CPU);
+    }
+
+    // start a processor thread per shard, then the input thread
+    std::vector<std::unique_ptr<Shard>> shards;
+    for (size_t index = 0; index < SHARD_COUNT; ++index) {
+        auto shard = std::make_unique<Shard>();
+        shard->index = index;
+        shard->commandQueue.setWaitStrategy(WAIT_STRATEGY);
+        shard->journal.setGroupCommit(JOURNAL_BATCH, JOURNAL_INTERVAL);
+        if (!shard->journal.open(STORAGE_DIR + "/journal-" + std::to_string(index) + ".bin", traderBase, SYMBOLS, true)) {
+            return 1;
+        }
+        shards.push_back(std::move(shard));
+    }
+    for (auto& shard : shards) {
+        shard->thread = std::thread(processor, std::ref(*shard), std::ref(instruments), std::ref(publisher), std::cref(traderBase));
+        if (!SHARD_CPUS.empty()) {
+            pinThread(shard->thread, SHARD_CPUS[shard->index % SHARD_CPUS.size()]);
+        } else if (PIN_SHARDS) {
+            pinThread(shard->thread, (shard->index + 1) % std::max(std::thread::hardware_concurrency(), 1u));
+        }
+    }
+    std::thread inputThread(inputHandler, std::ref(std::cin), std::ref(traderBase),
+                            std::ref(instruments), std::ref(shards), std::cref(publisher));
+    if (INPUT_CPU >= 0) {
+        pinThread(inputThread, INPUT_CPU);
+    }
 
     inputThread.join();
-    processingThread.join();
-
-    // save data back to storage
-    traderBase.saveToFile("../storage/traders.txt");
-    orderBook.saveToFile("../storage/orders.txt");
-    txList.saveToFile("../storage/transactions.txt");
-    return 0;
-}
\ No newline at end of file
+    for (auto& shard : shards) {
+        shard->thread.join();
+        shard->journal.close();
+    }
+    publisher.stop();
+    printStats(std::cout, shards, instruments, publisher);
+
+    // save a snapshot of every symbol; once they are all on disk the
+    // journals are removed since the snapshots cover them
+    bool saved = true;
+    for (auto& instrument : instruments) {
+        saved = instrument->snapshot.save(traderBase, instrument->orderBook, instrument->txList, instrument->lastOrderId,
+                                          instrument->engine.getJournalSequence()) && saved;
+    }
+    if (saved) {
+        for (const auto& path : findJournals()) {
+            std::error_code error;
+            std::filesystem::remove(path, error);
+        }
+    }
+    return saved ? 0 : 1;
+}
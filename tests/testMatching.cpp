@@ -1,69 +1,60 @@
 #include <gtest/gtest.h>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <limits>
 
-#include "../src/Order.h"
-#include "../src/OrderBook.h"
-#include "../src/TraderBase.h"
-#include "../src/Transaction.h"
-#include "../src/TransactionList.h"
-#include "../src/CommandType.h"
+#include "Order.h"
+#include "OrderBook.h"
+#include "TraderBase.h"
+#include "Transaction.h"
+#include "TransactionList.h"
+#include "CommandType.h"
+#include "CommandParser.h"
+#include "Price.h"
+#include "SpscQueue.h"
+#include "Journal.h"
+#include "Snapshot.h"
+#include "MarketDataPublisher.h"
+#include "RiskTable.h"
+#include "Stats.h"
+#include "TradeAnalytics.h"
+#include "Instrument.h"
+#include "MatchingEngine.h"
+#include "Runtime.h"
+#include "Replay.h"
 
-// Helper function to simulate input and process orders
-void simulateInput(OrderBook& orderBook, TransactionList& txList, const std::string& input) {
-    std::stringstream ss(input);
-    std::string type, username;
-    double totalPrice;
-    int quantity;
+// Trader registry and order id sequence shared by all tests
+TraderBase traderBase;
+OrderId nextOrderId = 1;
 
-    ss >> type;
-    CommandType commandType;
-    commandType = getOrderTypeFromString(type);
-
-    if (!(ss >> username >> totalPrice >> quantity)) {
-        return;
+// Helper function to simulate input and process orders through the
+// matching engine, as the processor thread does.
+// Returns the id assigned to a new order, or 0 if none was assigned.
+OrderId simulateInput(OrderBook& orderBook, TransactionList& txList, const std::string& input) {
+    ParsedCommand parsed;
+    if (parseCommand(input, parsed) != ParseError::NONE) {
+        return 0;
     }
-    if (quantity <= 0) {
-        return;
+    bool isOrder = parsed.type == CommandType::BUY || parsed.type == CommandType::SELL;
+    if (!isOrder && parsed.type != CommandType::CANCEL && parsed.type != CommandType::AMEND) {
+        return 0;
     }
-    if (totalPrice <= 0) {
-        return;
+    Command command{parsed.type, parsed.orderId, 0, parsed.quantity, parsed.pricePerOne, parsed.orderType};
+    if (isOrder) {
+        command.orderId = nextOrderId++;
+        command.trader = traderBase.addTrader(parsed.trader);
+    } else if (!traderBase.findTrader(parsed.trader, command.trader)) {
+        return 0;
     }
 
     auto now = std::chrono::system_clock::now();
     time_t timestamp = std::chrono::system_clock::to_time_t(now);
-
-    auto newOrder = std::make_unique<Order>(quantity, totalPrice, timestamp, username);
-
-    if (commandType == CommandType::BUY) {
-        orderBook.addBuyOrder(std::move(newOrder));
-    } else if (commandType == CommandType::SELL) {
-        orderBook.addSellOrder(std::move(newOrder));
-    }
-
-    // Process orders
-    while (orderBook.getFrontSellOrder() && orderBook.getFrontBuyOrder() &&
-           orderBook.getFrontSellOrder()->getPricePerOne() <= orderBook.getFrontBuyOrder()->getPricePerOne() &&
-           orderBook.getFrontSellOrder()->getTrader() != orderBook.getFrontBuyOrder()->getTrader()) {
-        Order* minSellOrder = orderBook.getFrontSellOrder();
-        Order* maxBuyOrder = orderBook.getFrontBuyOrder();
-        if (minSellOrder->getQuantity() == maxBuyOrder->getQuantity()) {
-            auto tx = std::make_unique<Transaction>(minSellOrder->getQuantity(), minSellOrder->getPricePerOne(), timestamp, minSellOrder->getTrader(), maxBuyOrder->getTrader());
-            txList.addTransaction(std::move(tx));
-            orderBook.popBuyOrder();
-            orderBook.popSellOrder();
-        } else if (minSellOrder->getQuantity() > maxBuyOrder->getQuantity()) {
-            auto tx = std::make_unique<Transaction>(maxBuyOrder->getQuantity(), minSellOrder->getPricePerOne(), timestamp, minSellOrder->getTrader(), maxBuyOrder->getTrader());
-            txList.addTransaction(std::move(tx));
-            minSellOrder->changeQuantity(maxBuyOrder->getQuantity());
-            orderBook.popBuyOrder();
-        } else {
-            auto tx = std::make_unique<Transaction>(minSellOrder->getQuantity(), minSellOrder->getPricePerOne(), timestamp, minSellOrder->getTrader(), maxBuyOrder->getTrader());
-            txList.addTransaction(std::move(tx));
-            maxBuyOrder->changeQuantity(minSellOrder->getQuantity());
-            orderBook.popSellOrder();
-        }
-    }
+    MatchingEngine(orderBook, txList).submit(command, timestamp);
+    return isOrder ? command.orderId : 0;
 }
 
 // Test:        Simple match
@@ -130,6 +121,22 @@ TEST(OrderBookTest, MultipleOrdersSomeMatch) {
     EXPECT_EQ(txList.getSize(), 1);
 }
 
+// Test:        Time priority within a price level
+// Input:       2 buy orders at the same price submitted within the same second, then 1 sell order
+// Expected:    The earlier buy order is filled and the later one stays at the front of the book
+TEST(OrderBookTest, FifoWithinPriceLevel) {
+    OrderBook orderBook;
+    TransactionList txList;
+
+    simulateInput(orderBook, txList, "buy Alice 100 1");
+    simulateInput(orderBook, txList, "buy Charlie 100 1");
+    simulateInput(orderBook, txList, "sell Bob 100 1");
+
+    ASSERT_NE(orderBook.getFrontBuyOrder(), nullptr);
+    EXPECT_EQ(traderBase.getName(orderBook.getFrontBuyOrder()->getTrader()), "Charlie");
+    EXPECT_EQ(traderBase.getName(txList.getLastN(1)[0].getBuyer()), "Alice");
+}
+
 // Test:        While loop continues to match unless no match
 // Input:       10 Buy orders of price = 10 and quantity = 1, and 1 Sell order of price = 100 and quantity = 10.
 // Expected:    10 transactions and empty orderbook
@@ -149,7 +156,8 @@ TEST(OrderBookTest, FullMatch) {
 
 // Test:        Buy and Sell orders from the same user must not match
 // Input:       Buy and Sell orders with matching prices from one user
-// Expected:    Orders remain in orderBook and txList size equals 0
+// Expected:    No transaction; by default the incoming sell order is
+//              cancelled and the resting buy order stays
 TEST(OrderBookTest, SameUserNoMatch) {
     OrderBook orderBook;
     TransactionList txList;
@@ -158,25 +166,22 @@ TEST(OrderBookTest, SameUserNoMatch) {
     simulateInput(orderBook, txList, "sell Alice 100 1");
 
     EXPECT_NE(orderBook.getFrontBuyOrder(), nullptr);
-    EXPECT_NE(orderBook.getFrontSellOrder(), nullptr);
+    EXPECT_EQ(orderBook.getFrontSellOrder(), nullptr);
     EXPECT_EQ(txList.getSize(), 0);
 }
 
-// Test:        Send invalid command type and check if exception is thrown
+// Test:        Send invalid command type and check the reported error
 // Input:       invalid command "invalid Alice 100 1"
-// Expected:    invalid_argument to be thrown
+// Expected:    UNKNOWN_COMMAND error naming the command, nothing processed
 TEST(OrderBookTest, InvalidCommand) {
     OrderBook orderBook;
     TransactionList txList;
-    EXPECT_THROW({
-        try{
-            simulateInput(orderBook, txList, "invalid Alice 100 1");
-        }
-        catch (std::invalid_argument& e) {
-            EXPECT_STREQ("Invalid command: \"invalid\"", e.what() );
-            return;
-        }
-    }, std::invalid_argument);
+    ParsedCommand command;
+    ParseError error = parseCommand("invalid Alice 100 1", command);
+    EXPECT_EQ(error, ParseError::UNKNOWN_COMMAND);
+    EXPECT_EQ(describeParseError(error, command), "Invalid command: \"invalid\"");
+    EXPECT_EQ(simulateInput(orderBook, txList, "invalid Alice 100 1"), 0);
+    EXPECT_EQ(orderBook.getFrontBuyOrder(), nullptr);
 }
 
 // Test:        Send invalid command format and check if order is processed
@@ -198,6 +203,1178 @@ TEST(OrderBookTest, InvalidInput) {
     EXPECT_EQ(txList.getSize(), 0);                         // No valid transactions should occur
 }
 
+// Test:        Every command form and error of the shared parser
+// Input:       Interactive and replay lines, valid and invalid
+// Expected:    Parsed fields and the error code of each malformed line
+TEST(CommandParserTest, ParseCommands) {
+    ParsedCommand command;
+    ASSERT_EQ(parseCommand("  sell @ACME Bob 12.50 5 ioc\r", command), ParseError::NONE);
+    EXPECT_EQ(command.type, CommandType::SELL);
+    EXPECT_EQ(command.symbol, "ACME");
+    EXPECT_EQ(command.trader, "Bob");
+    EXPECT_EQ(command.pricePerOne, 250);
+    EXPECT_EQ(command.quantity, 5);
+    EXPECT_EQ(command.orderType, OrderType::IOC);
+
+    ASSERT_EQ(parseReplayLine("1700000000 buy Alice market 3", command), ParseError::NONE);
+    EXPECT_EQ(command.timestamp, 1700000000);
+    EXPECT_EQ(command.orderType, OrderType::MARKET);
+    EXPECT_TRUE(command.symbol.empty());
+
+    ASSERT_EQ(parseCommand("amend Bob 7 2", command), ParseError::NONE);
+    EXPECT_EQ(command.trader, "Bob");
+    EXPECT_EQ(command.orderId, 7);
+    EXPECT_EQ(command.quantity, 2);
+    ASSERT_EQ(parseCommand("txlist @ACME", command), ParseError::NONE);
+    EXPECT_EQ(command.symbol, "ACME");
+
+    EXPECT_EQ(parseCommand(" \t", command), ParseError::EMPTY);
+    EXPECT_EQ(parseCommand("cancel Bob 12x", command), ParseError::MISSING_ORDER_ID);
+    EXPECT_EQ(parseCommand("cancel 12", command), ParseError::MISSING_ORDER_ID);
+    EXPECT_EQ(parseCommand("amend Bob 7 0", command), ParseError::INVALID_QUANTITY);
+    EXPECT_EQ(parseCommand("buy Alice 0 1", command), ParseError::INVALID_TOTAL_PRICE);
+    EXPECT_EQ(parseCommand("buy Alice 1.01 2", command), ParseError::PRICE_NOT_IN_TICKS);
+    EXPECT_EQ(parseCommand("buy Alice 100 1 gtc", command), ParseError::UNKNOWN_ORDER_TYPE);
+    EXPECT_EQ(command.invalidToken, "gtc");
+    EXPECT_EQ(parseReplayLine("now buy Alice 100 1", command), ParseError::INVALID_TIMESTAMP);
+    EXPECT_EQ(parseReplayLine("0 buy Alice 100 1", command), ParseError::INVALID_TIMESTAMP);
+    EXPECT_EQ(parseCommand("buy Alice market 5 garbage", command), ParseError::UNEXPECTED_ARGUMENT);
+    EXPECT_EQ(command.invalidToken, "garbage");
+    EXPECT_EQ(parseCommand("sell Bob 100 1 ioc now", command), ParseError::UNEXPECTED_ARGUMENT);
+    EXPECT_EQ(parseCommand("cancel Bob 7 8", command), ParseError::UNEXPECTED_ARGUMENT);
+    EXPECT_EQ(parseCommand("cancel 7", command), ParseError::MISSING_ORDER_ID);
+    EXPECT_EQ(parseCommand("amend 7 2", command), ParseError::MISSING_AMEND_ARGUMENTS);
+    EXPECT_EQ(parseCommand("buy @ Alice 100 1", command), ParseError::MISSING_SYMBOL);
+}
+
+// Test:        Fractional prices land on the same price level
+// Input:       Buy order with total price 0.3 for 3 items and Sell order with price 0.1 for 1 item
+// Expected:    Both are priced at exactly 10 ticks and match
+TEST(OrderBookTest, FractionalPriceMatch) {
+    OrderBook orderBook;
+    TransactionList txList;
+
+    simulateInput(orderBook, txList, "buy Alice 0.3 3");
+    simulateInput(orderBook, txList, "sell Bob 0.1 1");
+
+    EXPECT_EQ(txList.getSize(), 1);
+    ASSERT_NE(orderBook.getFrontBuyOrder(), nullptr);
+    EXPECT_EQ(orderBook.getFrontBuyOrder()->getPricePerOne(), 10);
+    EXPECT_EQ(orderBook.getFrontBuyOrder()->getQuantity(), 2);
+}
+
+// Test:        Prices that are not a whole number of ticks are rejected
+// Input:       Tick size of 0.05, orders priced at 0.03, 0.125 and 1 / 3 per item
+// Expected:    No order is added; a price on the tick grid is accepted
+TEST(OrderBookTest, OffTickPriceRejected) {
+    OrderBook orderBook;
+    TransactionList txList;
+    ASSERT_TRUE(setPriceConfig({2, 5}));
+
+    simulateInput(orderBook, txList, "buy Alice 0.03 1");
+    simulateInput(orderBook, txList, "buy Alice 0.125 1");
+    simulateInput(orderBook, txList, "buy Alice 1 3");
+    EXPECT_EQ(orderBook.getFrontBuyOrder(), nullptr);
+
+    simulateInput(orderBook, txList, "buy Alice 0.15 1");
+    ASSERT_NE(orderBook.getFrontBuyOrder(), nullptr);
+    EXPECT_EQ(orderBook.getFrontBuyOrder()->getPricePerOne(), 3);
+    EXPECT_EQ(formatPrice(orderBook.getFrontBuyOrder()->getPricePerOne()), "0.15");
+
+    ASSERT_TRUE(setPriceConfig({}));
+}
+
+// Test:        Decimal price parsing and formatting
+// Input:       Valid and invalid price strings with the default scale of 2
+// Expected:    Exact unit values, rejection of malformed or over-precise input
+TEST(PriceTest, ParseAndFormat) {
+    int64_t units;
+    EXPECT_TRUE(parsePriceUnits("12.34", units));
+    EXPECT_EQ(units, 1234);
+    EXPECT_TRUE(parsePriceUnits("7", units));
+    EXPECT_EQ(units, 700);
+    EXPECT_TRUE(parsePriceUnits("0.500", units));
+    EXPECT_EQ(units, 50);
+    EXPECT_TRUE(parsePriceUnits("-1.5", units));
+    EXPECT_EQ(units, -150);
+    EXPECT_FALSE(parsePriceUnits("0.001", units));
+    EXPECT_FALSE(parsePriceUnits("abc", units));
+    EXPECT_FALSE(parsePriceUnits("1.2.3", units));
+    EXPECT_FALSE(parsePriceUnits("", units));
+
+    EXPECT_EQ(formatPrice(1234), "12.34");
+    EXPECT_EQ(formatPrice(1250), "12.5");
+    EXPECT_EQ(formatPrice(700), "7");
+    EXPECT_EQ(formatPrice(5), "0.05");
+}
+
+// Test:        Order slots are recycled by the pool
+// Input:       10.000 rounds of a resting buy order fully matched by a sell order
+// Expected:    One slab serves every order and no order stays live
+TEST(OrderBookTest, OrderPoolRecycling) {
+    OrderBook orderBook;
+    TransactionList txList;
+
+    for (int i = 0; i < 10000; ++i) {
+        simulateInput(orderBook, txList, "buy Alice 100 1");
+        simulateInput(orderBook, txList, "sell Bob 100 1");
+    }
+
+    const PoolStats& stats = orderBook.getOrderPoolStats();
+    EXPECT_EQ(stats.slabs, 1);
+    EXPECT_EQ(stats.allocations, 10000); // the sell orders fill without resting
+    EXPECT_EQ(stats.releases, 10000);
+    EXPECT_EQ(stats.live, 0);
+    EXPECT_EQ(txList.getSize(), 10000);
+}
+
+// Test:        Trader names are interned to stable ids
+// Input:       Registering the same names repeatedly
+// Expected:    Each name keeps the id from its first registration and resolves back to its name
+TEST(TraderBaseTest, Interning) {
+    TraderBase traders;
+    TraderId alice = traders.addTrader("Alice");
+    TraderId bob = traders.addTrader("Bob");
+
+    EXPECT_NE(alice, bob);
+    EXPECT_EQ(traders.addTrader("Alice"), alice);
+    EXPECT_EQ(traders.getSize(), 2);
+    EXPECT_EQ(traders.getName(bob), "Bob");
+
+    TraderId found;
+    EXPECT_TRUE(traders.findTrader("Bob", found));
+    EXPECT_EQ(found, bob);
+    EXPECT_FALSE(traders.findTrader("Charlie", found));
+}
+
+// Test:        Commands cross the SPSC queue intact and in order with every wait strategy
+// Input:       100.000 commands pushed by a producer thread through a queue of 1024 slots
+// Expected:    The consumer receives every command exactly once, in push order
+TEST(SpscQueueTest, TransfersInOrder) {
+    for (WaitStrategy strategy : {WaitStrategy::BUSY_SPIN, WaitStrategy::SPIN_YIELD, WaitStrategy::BLOCKING}) {
+        auto queue = std::make_unique<SpscQueue<Command, 1024>>(strategy);
+        const int count = 100000;
+        std::thread producer([&queue] {
+            for (int i = 0; i < count; ++i) {
+                queue->push(Command{.type = CommandType::BUY, .quantity = i, .pricePerOne = i});
+            }
+            queue->push(Command{.type = CommandType::EXIT});
+        });
+
+        int received = 0;
+        bool inOrder = true;
+        Command command;
+        for (queue->pop(command); command.type != CommandType::EXIT; queue->pop(command)) {
+            inOrder = inOrder && command.quantity == received && command.pricePerOne == received;
+            ++received;
+        }
+        producer.join();
+
+        EXPECT_TRUE(inOrder);
+        EXPECT_EQ(received, count);
+        EXPECT_EQ(queue->size(), 0);
+    }
+}
+
+// Test:        A marketable order that fully fills never rests in the book
+// Input:       Resting sell orders of 3 and 2 items, then a buy order for 5 items
+// Expected:    Two fills and an empty book; only the resting orders used pool slots
+TEST(OrderBookTest, AggressiveOrderDoesNotRest) {
+    OrderBook orderBook;
+    TransactionList txList;
+
+    simulateInput(orderBook, txList, "sell Bob 30 3");
+    simulateInput(orderBook, txList, "sell Dave 22 2");
+    simulateInput(orderBook, txList, "buy Alice 55 5");
+
+    EXPECT_EQ(orderBook.getFrontBuyOrder(), nullptr);
+    EXPECT_EQ(orderBook.getFrontSellOrder(), nullptr);
+    EXPECT_EQ(txList.getSize(), 2);
+    EXPECT_EQ(orderBook.getOrderPoolStats().allocations, 2);
+
+    // the aggressive buy sweeps the cheaper level first
+    std::vector<Transaction> fills = txList.getLastN(2);
+    EXPECT_EQ(fills[1].getPricePerOne(), 1000);
+    EXPECT_EQ(fills[1].getQuantity(), 3);
+    EXPECT_EQ(fills[0].getPricePerOne(), 1100);
+    EXPECT_EQ(fills[0].getQuantity(), 2);
+}
+
+// Test:        Cancel a resting order from the middle of a price level
+// Input:       3 buy orders at one price, cancel the second, then sell 2 items
+// Expected:    The first and third orders fill; cancelling again or an unknown id fails
+TEST(OrderBookTest, CancelOrder) {
+    OrderBook orderBook;
+    TransactionList txList;
+
+    OrderId first = simulateInput(orderBook, txList, "buy Alice 100 1");
+    OrderId second = simulateInput(orderBook, txList, "buy Charlie 100 1");
+    OrderId third = simulateInput(orderBook, txList, "buy Dave 100 1");
+
+    EXPECT_TRUE(orderBook.cancelOrder(second));
+    EXPECT_FALSE(orderBook.cancelOrder(second));
+    EXPECT_FALSE(orderBook.cancelOrder(third + 100));
+    EXPECT_EQ(orderBook.findOrder(second), nullptr);
+    EXPECT_NE(orderBook.findOrder(first), nullptr);
+
+    simulateInput(orderBook, txList, "sell Bob 200 2");
+    EXPECT_EQ(txList.getSize(), 2);
+    EXPECT_EQ(orderBook.getFrontBuyOrder(), nullptr);
+    EXPECT_EQ(orderBook.getFrontSellOrder(), nullptr);
+    EXPECT_EQ(orderBook.getOrderPoolStats().live, 0);
+}
+
+// Test:        Cancelling the only order of the best level exposes the next level
+// Input:       Sell orders at 100 and 110, cancel the one at 100
+// Expected:    The front sell order is the one at 110
+TEST(OrderBookTest, CancelEmptiesBestLevel) {
+    OrderBook orderBook;
+    TransactionList txList;
+
+    OrderId best = simulateInput(orderBook, txList, "sell Bob 100 1");
+    OrderId next = simulateInput(orderBook, txList, "sell Bob 110 1");
+    simulateInput(orderBook, txList, "cancel Bob " + std::to_string(best));
+
+    ASSERT_NE(orderBook.getFrontSellOrder(), nullptr);
+    EXPECT_EQ(orderBook.getFrontSellOrder()->getId(), next);
+}
+
+// Test:        Amend keeps priority when reducing and loses it when increasing
+// Input:       2 buy orders at one price; the first is reduced, then increased
+// Expected:    After the reduction the first order is still at the front,
+//              after the increase the second order is
+TEST(OrderBookTest, AmendOrder) {
+    OrderBook orderBook;
+    TransactionList txList;
+
+    OrderId first = simulateInput(orderBook, txList, "buy Alice 500 5");
+    OrderId second = simulateInput(orderBook, txList, "buy Charlie 100 1");
+
+    simulateInput(orderBook, txList, "amend Alice " + std::to_string(first) + " 3");
+    ASSERT_NE(orderBook.getFrontBuyOrder(), nullptr);
+    EXPECT_EQ(orderBook.getFrontBuyOrder()->getId(), first);
+    EXPECT_EQ(orderBook.getFrontBuyOrder()->getQuantity(), 3);
+
+    simulateInput(orderBook, txList, "amend Alice " + std::to_string(first) + " 4");
+    EXPECT_EQ(orderBook.getFrontBuyOrder()->getId(), second);
+    EXPECT_EQ(orderBook.findOrder(first)->getQuantity(), 4);
+    EXPECT_FALSE(orderBook.amendOrder(first, 0));
+}
+
+// Test:        Price level totals follow adds, fills, amends and cancels
+// Input:       3 buy orders on 2 levels and 2 sell orders; a partial fill,
+//              an amend and a cancel that empties a level
+// Expected:    Depth shows one buy level with the remaining quantity and both sell levels
+TEST(OrderBookTest, DepthLevels) {
+    OrderBook orderBook;
+    TransactionList txList;
+
+    simulateInput(orderBook, txList, "buy Alice 500 5");
+    OrderId bob = simulateInput(orderBook, txList, "buy Bob 300 3");
+    OrderId carol = simulateInput(orderBook, txList, "buy Carol 180 2");
+    simulateInput(orderBook, txList, "sell Dave 440 4");
+    simulateInput(orderBook, txList, "sell Erin 120 1");
+    simulateInput(orderBook, txList, "sell Frank 200 2");
+    simulateInput(orderBook, txList, "amend Bob " + std::to_string(bob) + " 1");
+    simulateInput(orderBook, txList, "cancel Carol " + std::to_string(carol));
+
+    DepthLevel levels[10];
+    ASSERT_EQ(orderBook.getBuyDepth(levels, 10), 1);
+    EXPECT_EQ(levels[0].price, 10000);
+    EXPECT_EQ(levels[0].quantity, 4);
+    EXPECT_EQ(levels[0].orders, 2);
+
+    ASSERT_EQ(orderBook.getSellDepth(levels, 10), 2);
+    EXPECT_EQ(levels[0].price, 11000);
+    EXPECT_EQ(levels[0].quantity, 4);
+    EXPECT_EQ(levels[1].price, 12000);
+    EXPECT_EQ(levels[1].quantity, 1);
+    EXPECT_EQ(orderBook.getSellDepth(levels, 1), 1);
+}
+
+// Test:        Levels are ordered across the edges of the price ladder window
+// Input:       Sell orders inside and on both sides of the window centred on the
+//              first price (10000 ticks), a buy sweeping 5 of them, buy orders
+//              on a fresh side, and a sell side emptied and refilled far away
+// Expected:    Depth is in price order on both sides, the sweep takes the 5 best
+//              sell levels, and the emptied side moves its window to the new price
+TEST(OrderBookTest, PriceLadderWindow) {
+    OrderBook orderBook;
+    TransactionList txList;
+    MatchingEngine engine(orderBook, txList);
+    OrderId id = 0;
+    auto submit = [&](CommandType type, Price price, int quantity, TraderId trader) {
+        Command command{};
+        command.type = type;
+        command.orderId = ++id;
+        command.quantity = quantity;
+        command.pricePerOne = price;
+        command.trader = trader;
+        engine.submit(command, 0);
+        return id;
+    };
+    const Price windowEnd = 10000 + static_cast<Price>(OccupancyBitmap::SIZE / 2);
+
+    for (Price price : {Price(10000), Price(500000), Price(50), windowEnd - 1, windowEnd, Price(30480)}) {
+        submit(CommandType::SELL, price, 1, 1);
+    }
+    DepthLevel levels[10];
+    ASSERT_EQ(orderBook.getSellDepth(levels, 10), 6);
+    Price expected[] = {50, 10000, 30480, windowEnd - 1, windowEnd, 500000};
+    for (int i = 0; i < 6; ++i) {
+        EXPECT_EQ(levels[i].price, expected[i]);
+    }
+
+    submit(CommandType::BUY, 400000, 5, 2);
+    EXPECT_EQ(txList.getSize(), 5);
+    ASSERT_NE(orderBook.getFrontSellOrder(), nullptr);
+    EXPECT_EQ(orderBook.getFrontSellOrder()->getPricePerOne(), 500000);
+    EXPECT_EQ(orderBook.getFrontBuyOrder(), nullptr);
+
+    OrderId far = submit(CommandType::BUY, 209000, 1, 2);
+    submit(CommandType::BUY, 9000, 1, 2);
+    submit(CommandType::BUY, 1, 1, 2);
+    ASSERT_EQ(orderBook.getBuyDepth(levels, 10), 3);
+    EXPECT_EQ(levels[0].price, 209000);
+    EXPECT_EQ(levels[1].price, 9000);
+    EXPECT_EQ(levels[2].price, 1);
+    orderBook.cancelOrder(far);
+    EXPECT_EQ(orderBook.getFrontBuyOrder()->getPricePerOne(), 9000);
+
+    orderBook.popSellOrder();
+    submit(CommandType::SELL, 900000, 1, 1);
+    submit(CommandType::SELL, 900001, 1, 1);
+    ASSERT_EQ(orderBook.getSellDepth(levels, 10), 2);
+    EXPECT_EQ(levels[0].price, 900000);
+    EXPECT_EQ(levels[1].price, 900001);
+    EXPECT_TRUE(orderBook.buyWouldCross(900000));
+    EXPECT_FALSE(orderBook.buyWouldCross(899999));
+}
+
+// Test:        An outlier first price does not keep a side outside the ladder window
+// Input:       A buy far from the market starts the side, buys near 10000 ticks
+//              follow, then the outlier is cancelled and the others are
+//              cancelled, amended and filled
+// Expected:    The levels the window takes over keep their orders in time
+//              order, and cancels, amends and fills find them as before
+TEST(OrderBookTest, PriceLadderRecentresAfterOutlier) {
+    OrderBook orderBook;
+    TransactionList txList;
+    MatchingEngine engine(orderBook, txList);
+    engine.submit(Command{CommandType::BUY, 1, 1, 1, 5000000}, 0);
+    engine.submit(Command{CommandType::BUY, 2, 1, 2, 10000}, 0);
+    engine.submit(Command{CommandType::BUY, 3, 2, 3, 10000}, 0);
+    engine.submit(Command{CommandType::BUY, 4, 1, 4, 9999}, 0);
+    engine.submit(Command{CommandType::BUY, 5, 1, 5, 10001}, 0);
+
+    ASSERT_TRUE(orderBook.cancelOrder(1));
+    DepthLevel levels[10];
+    ASSERT_EQ(orderBook.getBuyDepth(levels, 10), 3);
+    EXPECT_EQ(levels[0].price, 10001);
+    EXPECT_EQ(levels[1].price, 10000);
+    EXPECT_EQ(levels[1].quantity, 5);
+    EXPECT_EQ(levels[2].price, 9999);
+
+    ASSERT_TRUE(orderBook.cancelOrder(5));
+    EXPECT_EQ(engine.submit(Command{CommandType::AMEND, 4, 1, 1}, 0).status, CommandStatus::DONE);
+    SubmitResult result = engine.submit(Command{CommandType::SELL, 6, 3, 6, 9999}, 0);
+    ASSERT_EQ(result.fills.size(), 3);
+    EXPECT_EQ(result.fills[0].getBuyer(), 1);
+    EXPECT_EQ(result.fills[0].getQuantity(), 2);
+    EXPECT_EQ(result.fills[1].getBuyer(), 2);
+    EXPECT_EQ(result.fills[2].getPricePerOne(), 9999);
+    EXPECT_EQ(result.fills[2].getQuantity(), 1);
+    EXPECT_EQ(orderBook.getFrontBuyOrder(), nullptr);
+}
+
+// Test:        Immediate-or-cancel orders never rest
+// Input:       Sell 2 items, then an IOC buy for 5 items at the same price
+// Expected:    2 items fill and the remaining 3 are discarded
+TEST(OrderTypeTest, ImmediateOrCancel) {
+    OrderBook orderBook;
+    TransactionList txList;
+
+    simulateInput(orderBook, txList, "sell Bob 200 2");
+    simulateInput(orderBook, txList, "buy Alice 500 5 ioc");
+
+    EXPECT_EQ(txList.getSize(), 1);
+    EXPECT_EQ(txList.getLastN(1)[0].getQuantity(), 2);
+    EXPECT_EQ(orderBook.getFrontBuyOrder(), nullptr);
+    EXPECT_EQ(orderBook.getFrontSellOrder(), nullptr);
+}
+
+// Test:        Fill-or-kill orders fill completely or leave the book untouched
+// Input:       Sell orders for 2 + 2 items, FOK buys for 5 and then 4 items
+// Expected:    The first FOK does nothing, the second fills both sell orders
+TEST(OrderTypeTest, FillOrKill) {
+    OrderBook orderBook;
+    TransactionList txList;
+
+    simulateInput(orderBook, txList, "sell Bob 200 2");
+    simulateInput(orderBook, txList, "sell Dave 220 2");
+
+    simulateInput(orderBook, txList, "buy Alice 550 5 fok");
+    EXPECT_EQ(txList.getSize(), 0);
+    ASSERT_NE(orderBook.getFrontSellOrder(), nullptr);
+    EXPECT_EQ(orderBook.getFrontSellOrder()->getQuantity(), 2);
+
+    simulateInput(orderBook, txList, "buy Alice 440 4 fok");
+    EXPECT_EQ(txList.getSize(), 2);
+    EXPECT_EQ(orderBook.getFrontSellOrder(), nullptr);
+    EXPECT_EQ(orderBook.getFrontBuyOrder(), nullptr);
+}
+
+// Test:        Market orders match at any price and never rest
+// Input:       Buy orders at 100 and 90, a market sell for 3 items
+// Expected:    Both buy orders fill at their own prices, the remaining item is discarded
+TEST(OrderTypeTest, MarketOrder) {
+    OrderBook orderBook;
+    TransactionList txList;
+
+    simulateInput(orderBook, txList, "buy Alice 100 1");
+    simulateInput(orderBook, txList, "buy Charlie 90 1");
+    simulateInput(orderBook, txList, "sell Bob market 3");
+
+    ASSERT_EQ(txList.getSize(), 2);
+    std::vector<Transaction> fills = txList.getLastN(2);
+    EXPECT_EQ(fills[1].getPricePerOne(), 10000);
+    EXPECT_EQ(fills[0].getPricePerOne(), 9000);
+    EXPECT_EQ(orderBook.getFrontBuyOrder(), nullptr);
+    EXPECT_EQ(orderBook.getFrontSellOrder(), nullptr);
+}
+
+// Test:        Post-only orders are rejected if they would match
+// Input:       Sell at 100, post-only buys at 100 and 90
+// Expected:    The crossing buy is rejected, the other one rests
+TEST(OrderTypeTest, PostOnly) {
+    OrderBook orderBook;
+    TransactionList txList;
+
+    simulateInput(orderBook, txList, "sell Bob 100 1");
+    OrderId crossing = simulateInput(orderBook, txList, "buy Alice 100 1 post");
+    OrderId passive = simulateInput(orderBook, txList, "buy Alice 90 1 post");
+
+    EXPECT_EQ(txList.getSize(), 0);
+    EXPECT_EQ(orderBook.findOrder(crossing), nullptr);
+    ASSERT_NE(orderBook.getFrontBuyOrder(), nullptr);
+    EXPECT_EQ(orderBook.getFrontBuyOrder()->getId(), passive);
+}
+
+// Test:        Self-trade prevention policies
+// Input:       A trader's sell order with another trader's sell order behind it
+//              at the same price, then a crossing buy order from the first trader
+// Expected:    Each policy cancels or reduces the orders in place without a
+//              self-trade, and cancel-oldest goes on to fill against the other trader;
+//              a fill-or-kill order under decrement counts its own reduced order
+//              towards its quantity, as the sweep does
+TEST(OrderTypeTest, SelfTradePrevention) {
+    TraderId maker = traderBase.addTrader("Maker");
+    TraderId other = traderBase.addTrader("Other");
+    auto run = [&](SelfTradePrevention policy, CommandStatus expectedStatus) {
+        auto instrument = std::make_unique<Instrument>(0, "STP", ".");
+        instrument->engine.submit(Command{CommandType::SELL, 1, maker, 5, 100}, 0);
+        instrument->engine.submit(Command{CommandType::SELL, 2, other, 3, 100}, 0);
+        Command buy{CommandType::BUY, 3, maker, 4, 100};
+        buy.selfTrade = policy;
+        EXPECT_EQ(instrument->engine.submit(buy, 0).status, expectedStatus);
+        return instrument;
+    };
+    DepthLevel sells[1];
+
+    auto newest = run(SelfTradePrevention::CANCEL_NEWEST, CommandStatus::SELF_TRADE_CANCELLED);
+    EXPECT_EQ(newest->txList.getSize(), 0);
+    EXPECT_EQ(newest->orderBook.getFrontBuyOrder(), nullptr);
+    ASSERT_EQ(newest->orderBook.getSellDepth(sells, 1), 1);
+    EXPECT_EQ(sells[0].quantity, 8);
+
+    auto oldest = run(SelfTradePrevention::CANCEL_OLDEST, CommandStatus::DONE);
+    ASSERT_EQ(oldest->txList.getSize(), 1);
+    EXPECT_EQ(oldest->txList.getTransaction(0)->getSeller(), other);
+    EXPECT_EQ(oldest->txList.getTransaction(0)->getQuantity(), 3);
+    EXPECT_EQ(oldest->orderBook.getFrontSellOrder(), nullptr);
+    ASSERT_NE(oldest->orderBook.getFrontBuyOrder(), nullptr);
+    EXPECT_EQ(oldest->orderBook.getFrontBuyOrder()->getQuantity(), 1);
+
+    auto both = run(SelfTradePrevention::CANCEL_BOTH, CommandStatus::SELF_TRADE_CANCELLED);
+    EXPECT_EQ(both->txList.getSize(), 0);
+    EXPECT_EQ(both->orderBook.getFrontBuyOrder(), nullptr);
+    ASSERT_NE(both->orderBook.getFrontSellOrder(), nullptr);
+    EXPECT_EQ(both->orderBook.getFrontSellOrder()->getTrader(), other);
+
+    auto decrement = run(SelfTradePrevention::DECREMENT, CommandStatus::DONE);
+    EXPECT_EQ(decrement->txList.getSize(), 0);
+    EXPECT_EQ(decrement->orderBook.getFrontBuyOrder(), nullptr);
+    EXPECT_EQ(decrement->orderBook.findOrder(1)->getQuantity(), 1);
+    ASSERT_EQ(decrement->orderBook.getSellDepth(sells, 1), 1);
+    EXPECT_EQ(sells[0].quantity, 4);
+
+    Command fok{CommandType::BUY, 4, maker, 4, 100, OrderType::FOK};
+    fok.selfTrade = SelfTradePrevention::DECREMENT;
+    EXPECT_EQ(decrement->engine.submit(fok, 0).status, CommandStatus::DONE);
+    EXPECT_EQ(decrement->txList.getSize(), 1);
+    EXPECT_EQ(decrement->orderBook.getFrontSellOrder(), nullptr);
+}
+
+// Test:        The matching engine reports the fills of a command and of a batch
+// Input:       Two resting sells at different prices, a buy sweeping both, then a
+//              batch of a sell, a cancel of an unknown order and a crossing buy
+// Expected:    submit returns both fills best price first; submitMany returns the
+//              batch's fills and a status per command, and every fill is published;
+//              both date a fill by the command's own timestamp when it has one
+TEST(MatchingEngineTest, SubmitAndSubmitMany) {
+    TraderId seller = traderBase.addTrader("EngineSeller");
+    TraderId buyer = traderBase.addTrader("EngineBuyer");
+    OrderBook orderBook;
+    TransactionList txList;
+    MatchingEngine engine(orderBook, txList);
+    engine.submit(Command{CommandType::SELL, 1, seller, 2, 101}, 0);
+    engine.submit(Command{CommandType::SELL, 2, seller, 2, 100}, 0);
+
+    SubmitResult result = engine.submit(Command{CommandType::BUY, 3, buyer, 3, 101}, 7);
+    EXPECT_EQ(result.status, CommandStatus::DONE);
+    ASSERT_EQ(result.fills.size(), 2);
+    EXPECT_EQ(result.fills[0].getPricePerOne(), 100);
+    EXPECT_EQ(result.fills[0].getQuantity(), 2);
+    EXPECT_EQ(result.fills[1].getPricePerOne(), 101);
+    EXPECT_EQ(result.fills[1].getQuantity(), 1);
+    EXPECT_EQ(result.fills[1].getDate(), 7);
+    EXPECT_EQ(txList.getSize(), 2);
+
+    std::vector<Command> batch = {
+        Command{CommandType::SELL, 4, seller, 5, 102},
+        Command{CommandType::CANCEL, 99},
+        Command{CommandType::BUY, 5, buyer, 4, 102},
+    };
+    batch[2].timestamp = 9;
+    std::vector<CommandStatus> statuses(batch.size());
+    auto fills = engine.submitMany(batch, 8, statuses);
+    EXPECT_EQ(statuses[0], CommandStatus::DONE);
+    EXPECT_EQ(statuses[1], CommandStatus::ORDER_NOT_FOUND);
+    EXPECT_EQ(statuses[2], CommandStatus::DONE);
+    ASSERT_EQ(fills.size(), 2);
+    EXPECT_EQ(fills[0].getQuantity(), 1); // the rest of order 1
+    EXPECT_EQ(fills[1].getQuantity(), 3);
+    EXPECT_EQ(fills[1].getDate(), 9);
+    EXPECT_EQ(txList.getSize(), 4);
+    EXPECT_EQ(orderBook.findOrder(4)->getQuantity(), 2);
+
+    // a command's own timestamp wins over submit's, as in submitMany
+    Command timed{CommandType::BUY, 6, buyer, 1, 102};
+    timed.timestamp = 11;
+    result = engine.submit(timed, 10);
+    ASSERT_EQ(result.fills.size(), 1);
+    EXPECT_EQ(result.fills[0].getDate(), 11);
+}
+
+// Test:        Candles, VWAP and trader volume follow the fills
+// Input:       Fills of two traders over three minutes submitted through an engine
+//              with 1m and 1h candles, plus the candles command text
+// Expected:    One OHLCV candle per minute with fills, a single hourly candle,
+//              the running VWAP and each trader's bought and sold quantity
+TEST(TradeAnalyticsTest, IncrementalAggregates) {
+    ParsedCommand parsed;
+    ASSERT_EQ(parseCommand("candles @ACME 5m 20", parsed), ParseError::NONE);
+    EXPECT_EQ(parsed.type, CommandType::CANDLES);
+    EXPECT_EQ(parsed.interval, 300);
+    EXPECT_EQ(parsed.levels, 20);
+    EXPECT_EQ(parseCommand("candles 5x 20", parsed), ParseError::MISSING_CANDLE_ARGUMENTS);
+    EXPECT_EQ(parseCommand("volume", parsed), ParseError::MISSING_USERNAME);
+    EXPECT_EQ(formatInterval(3600), "1h");
+
+    TraderId seller = traderBase.addTrader("CandleSeller");
+    TraderId buyer = traderBase.addTrader("CandleBuyer");
+    OrderBook orderBook;
+    TransactionList txList;
+    TradeAnalytics analytics({60, 3600});
+    MatchingEngine engine(orderBook, txList, &analytics);
+    OrderId id = 1;
+    auto trade = [&](time_t timestamp, Price price, int quantity) {
+        engine.submit(Command{CommandType::SELL, id++, seller, quantity, price}, timestamp);
+        engine.submit(Command{CommandType::BUY, id++, buyer, quantity, price}, timestamp);
+    };
+    trade(3600, 100, 2);
+    trade(3630, 104, 1);
+    trade(3650, 98, 1);
+    trade(3720, 101, 4); // next minute
+    trade(3900, 102, 2); // a minute later, skipping one
+
+    std::vector<Candle> candles;
+    ASSERT_TRUE(analytics.getCandles(60, 10, candles));
+    ASSERT_EQ(candles.size(), 3);
+    EXPECT_EQ(candles[0].start, 3600);
+    EXPECT_EQ(candles[0].open, 100);
+    EXPECT_EQ(candles[0].high, 104);
+    EXPECT_EQ(candles[0].low, 98);
+    EXPECT_EQ(candles[0].close, 98);
+    EXPECT_EQ(candles[0].volume, 4);
+    EXPECT_EQ(getVwap(candles[0].notional, candles[0].volume), 101); // 402 / 4, rounded
+    EXPECT_EQ(candles[2].start, 3900);
+    ASSERT_TRUE(analytics.getCandles(60, 1, candles));
+    ASSERT_EQ(candles.size(), 1);
+    EXPECT_EQ(candles[0].close, 102);
+    ASSERT_TRUE(analytics.getCandles(3600, 10, candles));
+    ASSERT_EQ(candles.size(), 1);
+    EXPECT_EQ(candles[0].volume, 10);
+    EXPECT_FALSE(analytics.getCandles(300, 10, candles));
+
+    EXPECT_EQ(analytics.getFills(), 5);
+    EXPECT_EQ(getVwap(analytics.getNotional(), analytics.getVolume()), 101); // 1010 / 10
+    EXPECT_EQ(analytics.getTraderVolume(buyer).bought, 10);
+    EXPECT_EQ(analytics.getTraderVolume(buyer).sold, 0);
+    EXPECT_EQ(analytics.getTraderVolume(seller).sold, 10);
+}
+
+// Test:        Pre-trade risk limits and position tracking
+// Input:       A trade, then orders and amends near a position limit of 10 and an
+//              open quantity limit of 8, a cancel by another trader and by the owner,
+//              a self-trade cancelling a resting order, and an order submitted with
+//              the limits unchecked, as recovery does
+// Expected:    Orders or amends that could breach a limit are rejected without
+//              touching the book unless unchecked, as is the other trader's cancel;
+//              positions and open quantities follow every change
+TEST(RiskTest, PreTradeLimits) {
+    TraderId alice = traderBase.addTrader("RiskAlice");
+    TraderId bob = traderBase.addTrader("RiskBob");
+    TraderId carl = traderBase.addTrader("RiskCarl");
+    OrderBook orderBook;
+    TransactionList txList;
+    RiskTable risk;
+    risk.setLimits(RiskLimits{.maxPosition = 10, .maxOpenQuantity = 8});
+    MatchingEngine engine(orderBook, txList, nullptr, &risk);
+    auto submit = [&](CommandType type, OrderId id, TraderId trader, int quantity, Price price) {
+        return engine.submit(Command{type, id, trader, quantity, price}, 0).status;
+    };
+
+    EXPECT_EQ(submit(CommandType::SELL, 1, alice, 5, 100), CommandStatus::DONE);
+    EXPECT_EQ(submit(CommandType::BUY, 2, bob, 5, 100), CommandStatus::DONE);
+    EXPECT_EQ(risk.getTraderRisk(bob).position, 5);
+    EXPECT_EQ(risk.getTraderRisk(alice).position, -5);
+    EXPECT_EQ(risk.getTraderRisk(alice).openSell, 0);
+
+    EXPECT_EQ(submit(CommandType::BUY, 3, bob, 6, 99), CommandStatus::RISK_LIMIT_EXCEEDED);
+    EXPECT_EQ(orderBook.getFrontBuyOrder(), nullptr);
+    EXPECT_EQ(submit(CommandType::BUY, 4, bob, 5, 99), CommandStatus::DONE);
+    EXPECT_EQ(risk.getTraderRisk(bob).openBuy, 5);
+    EXPECT_EQ(risk.getTraderRisk(bob).openNotional, 495);
+    EXPECT_EQ(engine.submit(Command{.type = CommandType::AMEND, .orderId = 4, .trader = bob, .quantity = 6}, 0).status, CommandStatus::RISK_LIMIT_EXCEEDED);
+    EXPECT_EQ(engine.submit(Command{.type = CommandType::AMEND, .orderId = 4, .trader = bob, .quantity = 3}, 0).status, CommandStatus::DONE);
+    EXPECT_EQ(risk.getTraderRisk(bob).openBuy, 3);
+
+    EXPECT_EQ(submit(CommandType::SELL, 5, bob, 9, 200), CommandStatus::RISK_LIMIT_EXCEEDED); // 12 open
+    EXPECT_EQ(submit(CommandType::SELL, 6, bob, 5, 200), CommandStatus::DONE);
+    EXPECT_EQ(engine.submit(Command{.type = CommandType::CANCEL, .orderId = 6, .trader = alice}, 0).status, CommandStatus::NOT_ORDER_OWNER);
+    EXPECT_EQ(engine.submit(Command{.type = CommandType::CANCEL, .orderId = 6, .trader = bob}, 0).status, CommandStatus::DONE);
+    EXPECT_EQ(risk.getTraderRisk(bob).openSell, 0);
+    EXPECT_EQ(risk.getTraderRisk(bob).openNotional, 297);
+
+    EXPECT_EQ(submit(CommandType::SELL, 7, carl, 4, 100), CommandStatus::DONE);
+    Command buy{CommandType::BUY, 8, carl, 4, 100};
+    buy.selfTrade = SelfTradePrevention::CANCEL_OLDEST;
+    EXPECT_EQ(engine.submit(buy, 0).status, CommandStatus::DONE);
+    EXPECT_EQ(risk.getTraderRisk(carl).openSell, 0);
+    EXPECT_EQ(risk.getTraderRisk(carl).openBuy, 4);
+    EXPECT_EQ(risk.getTraderRisk(carl).position, 0);
+
+    // recovery re-applies accepted commands under the current limits unchecked
+    risk.setLimits(RiskLimits{.maxOpenQuantity = 1});
+    Command recovered{CommandType::BUY, 9, bob, 2, 98};
+    EXPECT_EQ(engine.submit(recovered, 0).status, CommandStatus::RISK_LIMIT_EXCEEDED);
+    EXPECT_EQ(engine.submit(recovered, 0, nullptr, false).status, CommandStatus::DONE);
+    EXPECT_EQ(risk.getTraderRisk(bob).openBuy, 5);
+}
+
+// Test:        The journal survives a restart and a torn last record
+// Input:       Orders, an amend and a cancel of two symbols journaled by one trader registry,
+//              replayed into a fresh one with the symbols listed in another order
+//              after a partial record is appended
+// Expected:    Every intact record is replayed in order with trader and symbol ids remapped
+//              by name, the torn tail is dropped and later appends replay again
+TEST(JournalTest, ReplayAfterTornWrite) {
+    const std::string filename = "journal_test.bin";
+    const std::vector<std::string> writerSymbols = {"DEFAULT", "AAPL"};
+    const std::vector<std::string> readerSymbols = {"AAPL", "MSFT", "DEFAULT"};
+    TraderBase writerTraders;
+    writerTraders.addTrader("Zed");
+    TraderId alice = writerTraders.addTrader("Alice");
+    TraderId bob = writerTraders.addTrader("Bob");
+
+    Journal journal;
+    journal.setGroupCommit(2, std::chrono::microseconds(100));
+    ASSERT_TRUE(journal.open(filename, writerTraders, writerSymbols, true));
+    journal.append(makeCommandRecord(Command{CommandType::BUY, 11, alice, 5, 100, OrderType::LIMIT}, 1000));
+    journal.append(makeCommandRecord(Command{CommandType::SELL, 12, bob, 2, 120, OrderType::POST_ONLY, 1}, 1001));
+    journal.append(makeCommandRecord(Command{.type = CommandType::AMEND, .orderId = 11, .quantity = 3}, 1002));
+    journal.append(makeCommandRecord(Command{.type = CommandType::CANCEL, .orderId = 12, .symbol = 1}, 1003));
+    journal.close();
+    {
+        std::ofstream torn(filename, std::ios::binary | std::ios::app);
+        torn << "partial";
+    }
+
+    TraderBase readerTraders;
+    TraderId readerBob = readerTraders.addTrader("Bob");
+    std::vector<JournalRecord> replayed;
+    auto collect = [&](const JournalRecord& record) { replayed.push_back(record); };
+    ASSERT_TRUE(Journal::replay(filename, readerTraders, readerSymbols, collect));
+
+    ASSERT_EQ(replayed.size(), 4);
+    Command buy = commandFromRecord(replayed[0]);
+    EXPECT_EQ(buy.type, CommandType::BUY);
+    EXPECT_EQ(buy.symbol, 2);
+    EXPECT_EQ(readerTraders.getName(buy.trader), "Alice");
+    EXPECT_EQ(buy.quantity, 5);
+    EXPECT_EQ(buy.pricePerOne, 100);
+    EXPECT_EQ(replayed[0].timestamp, 1000);
+    Command sell = commandFromRecord(replayed[1]);
+    EXPECT_EQ(sell.trader, readerBob);
+    EXPECT_EQ(sell.symbol, 0);
+    EXPECT_EQ(sell.orderType, OrderType::POST_ONLY);
+    EXPECT_EQ(commandFromRecord(replayed[2]).type, CommandType::AMEND);
+    EXPECT_EQ(commandFromRecord(replayed[3]).orderId, 12);
+    EXPECT_EQ(commandFromRecord(replayed[3]).symbol, 0);
+
+    // records appended after recovery follow the last intact one
+    ASSERT_TRUE(journal.open(filename, writerTraders, writerSymbols, false));
+    journal.append(makeCommandRecord(Command{CommandType::SELL, 13, alice, 1, 90, OrderType::LIMIT, 1}, 1004));
+    journal.close();
+    replayed.clear();
+    ASSERT_TRUE(Journal::replay(filename, readerTraders, readerSymbols, collect));
+    ASSERT_EQ(replayed.size(), 5);
+    EXPECT_EQ(replayed[4].orderId, 13);
+    EXPECT_EQ(replayed[4].symbol, 0);
+    EXPECT_EQ(readerTraders.getName(replayed[4].trader), "Alice");
+    std::remove(filename.c_str());
+}
+
+// Test:        The engine numbers the commands it journals
+// Input:       An engine resumed at journal sequence 5 takes an order, a cancel of it
+//              by another trader and a cancel by its owner, with a journal
+// Expected:    The rejected cancel is not journaled and the other two replay with
+//              sequence numbers 6 and 7, so recovery can tell them from the ones a
+//              snapshot already includes
+TEST(JournalTest, EngineNumbersJournaledCommands) {
+    const std::string filename = "journal_sequence_test.bin";
+    const std::vector<std::string> symbols = {"DEFAULT"};
+    TraderBase traders;
+    TraderId alice = traders.addTrader("Alice");
+    TraderId bob = traders.addTrader("Bob");
+    OrderBook orderBook;
+    TransactionList txList;
+    MatchingEngine engine(orderBook, txList);
+    engine.setJournalSequence(5);
+
+    Journal journal;
+    ASSERT_TRUE(journal.open(filename, traders, symbols, true));
+    engine.submit(Command{CommandType::BUY, 1, alice, 5, 100, OrderType::LIMIT}, 1000, &journal);
+    EXPECT_EQ(engine.submit(Command{.type = CommandType::CANCEL, .orderId = 1, .trader = bob}, 1001, &journal).status,
+              CommandStatus::NOT_ORDER_OWNER);
+    engine.submit(Command{.type = CommandType::CANCEL, .orderId = 1, .trader = alice}, 1002, &journal);
+    journal.close();
+    EXPECT_EQ(engine.getJournalSequence(), 7);
+
+    std::vector<JournalRecord> replayed;
+    ASSERT_TRUE(Journal::replay(filename, traders, symbols, [&](const JournalRecord& record) { replayed.push_back(record); }));
+    ASSERT_EQ(replayed.size(), 2);
+    EXPECT_EQ(replayed[0].sequence, 6);
+    EXPECT_EQ(replayed[1].type, JournalRecordType::CANCEL);
+    EXPECT_EQ(replayed[1].sequence, 7);
+    std::remove(filename.c_str());
+}
+
+// Test:        A replay gives the same fills every time
+// Input:       Orders, an amend, a cancel by the wrong trader and a query on two symbols,
+//              with a line of timestamp 0 and one of an unknown symbol, replayed twice
+// Expected:    Both logs are identical and hold just the two fills of the stream, at the
+//              timestamps of their lines; the invalid lines are skipped and the cancel
+//              is rejected
+TEST(ReplayTest, SameStreamSameLog) {
+    const std::string stream = "1700000000 sell Bob 100 5\n"
+                               "1700000001 buy @AAPL Alice 50 1\n"
+                               "1700000002 sell @AAPL Carl 40 1\n"
+                               "0 buy Alice 100 5\n"
+                               "1700000003 amend Bob 1 3\n"
+                               "1700000004 cancel Alice 1\n"
+                               "1700000005 vwap\n"
+                               "1700000006 buy Dave 100 5\n"
+                               "1700000007 buy @MSFT Eve 10 1\n";
+    std::string logs[2];
+    for (std::string& log : logs) {
+        Replay replay({"DEFAULT", "AAPL"}, SelfTradePrevention::CANCEL_NEWEST, RiskLimits{});
+        std::istringstream input(stream);
+        replay.run(input);
+        EXPECT_EQ(replay.getCommands(), 6);
+        EXPECT_EQ(replay.getRejected(), 1);
+        std::ostringstream output;
+        ASSERT_TRUE(replay.writeLog(output));
+        log = output.str();
+    }
+    EXPECT_EQ(logs[0], "DEFAULT 3 2000 1700000006 Bob Dave\nAAPL 1 4000 1700000002 Carl Alice\n");
+    EXPECT_EQ(logs[1], logs[0]);
+}
+
+// Test:        Commands of one symbol only reach that symbol
+// Input:       Orders for the default symbol and for "@AAPL", interleaved, including
+//              a cancel of AAPL order 1 and a sell of the default symbol that would
+//              match AAPL's resting buy if the books were shared
+// Expected:    Each symbol's book holds only its own orders, with ids counted from 1
+//              per symbol; nothing trades; and a symbol always maps to the same shard
+TEST(ReplayTest, RoutesCommandsBySymbol) {
+    const std::string stream = "1700000000 buy Alice 500 5\n"
+                               "1700000001 buy @AAPL Bob 1000 5\n"
+                               "1700000002 buy @AAPL Bob 600 3\n"
+                               "1700000003 cancel @AAPL Bob 1\n"
+                               "1700000004 sell Carl 1000 5\n";
+    Replay replay({"DEFAULT", "AAPL"}, SelfTradePrevention::CANCEL_NEWEST, RiskLimits{});
+    std::istringstream input(stream);
+    replay.run(input);
+    EXPECT_EQ(replay.getRejected(), 0);
+
+    const Instrument& first = replay.getInstrument(0);
+    const Instrument& aapl = replay.getInstrument(1);
+    EXPECT_EQ(first.lastOrderId, 2);
+    EXPECT_EQ(aapl.lastOrderId, 2);
+    EXPECT_EQ(first.txList.getSize(), 0);
+    EXPECT_EQ(aapl.txList.getSize(), 0);
+    // default symbol: Alice's buy (id 1) at 100 and Carl's sell (id 2) at 200
+    ASSERT_NE(first.orderBook.findOrder(1), nullptr);
+    EXPECT_TRUE(first.orderBook.findOrder(1)->isBuy());
+    ASSERT_NE(first.orderBook.findOrder(2), nullptr);
+    EXPECT_FALSE(first.orderBook.findOrder(2)->isBuy());
+    // AAPL: order 1 cancelled, Bob's second buy (id 2) rests alone
+    EXPECT_EQ(aapl.orderBook.findOrder(1), nullptr);
+    ASSERT_NE(aapl.orderBook.findOrder(2), nullptr);
+    EXPECT_EQ(aapl.orderBook.findOrder(2)->getQuantity(), 3);
+    EXPECT_EQ(aapl.orderBook.getOrderPoolStats().live, 1);
+
+    // symbols are dealt out in turn
+    for (SymbolId symbol = 0; symbol < 8; ++symbol) {
+        EXPECT_EQ(shardOf(symbol, 1), 0);
+        EXPECT_EQ(shardOf(symbol, 3), shardOf(symbol + 3, 3));
+    }
+    EXPECT_EQ(shardOf(0, 2), 0);
+    EXPECT_EQ(shardOf(1, 2), 1);
+    EXPECT_EQ(shardOf(2, 2), 0);
+}
+
+// Test:        The text storage keeps the order id sequence
+// Input:       A book whose newest orders have filled, saved to orders.txt with a
+//              higher last order id than any resting order, then loaded back
+// Expected:    The file starts with the format header, the resting orders come back
+//              and the loaded last order id is the saved one, so the ids of the
+//              filled orders are not handed out again
+TEST(OrderBookTest, TextStorageKeepsLastOrderId) {
+    const std::string filename = "orders_test.txt";
+    OrderBook orderBook;
+    TransactionList txList;
+    OrderId resting = simulateInput(orderBook, txList, "sell TextSeller 200 1");
+    simulateInput(orderBook, txList, "sell TextSeller 100 1");
+    OrderId last = simulateInput(orderBook, txList, "buy TextBuyer 200 1");
+    ASSERT_EQ(txList.getSize(), 1);
+    orderBook.saveToFile(filename, traderBase, last);
+
+    std::ifstream saved(filename);
+    std::string header;
+    std::getline(saved, header);
+    EXPECT_EQ(header, textStorageHeader());
+    OrderBook loaded;
+    ASSERT_TRUE(loaded.loadFromFile(filename, traderBase));
+    ASSERT_NE(loaded.findOrder(resting), nullptr);
+    EXPECT_EQ(loaded.getOrderPoolStats().live, 1);
+    EXPECT_EQ(loaded.getLastOrderId(), last);
+    std::remove(filename.c_str());
+}
+
+// Test:        Text storage of the first, decimal format is converted, other formats rejected
+// Input:       orders.txt and transactions.txt without a header and with decimal prices
+//              per item, then an orders file with the header of another price scale
+// Expected:    Prices are rounded to ticks, the orders get ids in file order, and the
+//              file of the other scale fails to load without adding any order
+TEST(OrderBookTest, TextStorageConvertsDecimalFormat) {
+    const std::string ordersFile = "orders_decimal_test.txt";
+    const std::string transactionsFile = "transactions_decimal_test.txt";
+    std::ofstream(ordersFile) << "buy 3 33.333333333333336 1700000000 Alice\n"
+                              << "sell 2 101.5 1700000001 Bob\n";
+    std::ofstream(transactionsFile) << "1 100 1700000000 Bob Alice\n";
+
+    OrderBook orderBook;
+    ASSERT_TRUE(orderBook.loadFromFile(ordersFile, traderBase));
+    ASSERT_NE(orderBook.findOrder(1), nullptr);
+    EXPECT_EQ(orderBook.findOrder(1)->getPricePerOne(), 3333);
+    EXPECT_EQ(orderBook.findOrder(1)->getQuantity(), 3);
+    ASSERT_NE(orderBook.findOrder(2), nullptr);
+    EXPECT_EQ(orderBook.findOrder(2)->getPricePerOne(), 10150);
+    EXPECT_EQ(orderBook.getLastOrderId(), 2);
+
+    TransactionList txList;
+    ASSERT_TRUE(txList.loadFromFile(transactionsFile, traderBase));
+    ASSERT_EQ(txList.getSize(), 1);
+    EXPECT_EQ(txList.getTransaction(0)->getPricePerOne(), 10000);
+    EXPECT_EQ(traderBase.getName(txList.getTransaction(0)->getBuyer()), "Alice");
+
+    std::ofstream(ordersFile) << "format 2 scale 3 tick 1\nbuy 1 3 33333 1700000000 Alice\n";
+    OrderBook rejected;
+    EXPECT_FALSE(rejected.loadFromFile(ordersFile, traderBase));
+    EXPECT_EQ(rejected.getOrderPoolStats().live, 0);
+    std::remove(ordersFile.c_str());
+    std::remove(transactionsFile.c_str());
+}
+
+// Test:        Orders that could not rest are not loaded from the text storage
+// Input:       orders.txt files holding a valid order and then one of quantity 0, one
+//              of a negative price, or a second order with the same id
+// Expected:    The valid order alone loads; each of the other files fails to load
+//              instead of the order entering the book
+TEST(OrderBookTest, TextStorageRejectsInvalidOrders) {
+    const std::string filename = "orders_invalid_test.txt";
+    const std::string invalidLines[] = {"buy 2 0 100 1700000000 Bob", "sell 2 1 -100 1700000000 Bob",
+                                        "sell 1 1 200 1700000000 Bob"};
+    std::ofstream(filename) << textStorageHeader() << "\nbuy 1 5 100 1700000000 Alice\n";
+    OrderBook valid;
+    ASSERT_TRUE(valid.loadFromFile(filename, traderBase));
+    ASSERT_NE(valid.findOrder(1), nullptr);
+    for (const std::string& invalid : invalidLines) {
+        std::ofstream(filename) << textStorageHeader() << "\nbuy 1 5 100 1700000000 Alice\n" << invalid << "\n";
+        OrderBook orderBook;
+        EXPECT_FALSE(orderBook.loadFromFile(filename, traderBase)) << invalid;
+    }
+    std::remove(filename.c_str());
+}
+
+// Test:        A binary snapshot restores the book, traders and transactions
+// Input:       A book with resting orders on both sides and one trade, saved, extended
+//              by another trade and saved again, then one byte of the snapshot corrupted
+// Expected:    Loading rebuilds the same priority order and transaction history,
+//              and a corrupt snapshot is rejected without touching the containers
+TEST(SnapshotTest, RoundTrip) {
+    const std::string snapshotFile = "snapshot_test.bin";
+    const std::string transactionsFile = "snapshot_test_tx.bin";
+    std::remove(transactionsFile.c_str());
+    OrderBook orderBook;
+    TransactionList txList;
+    simulateInput(orderBook, txList, "sell Bob 100 1");
+    simulateInput(orderBook, txList, "sell Carl 100 1");
+    OrderId buyId = simulateInput(orderBook, txList, "buy Dave 90 2");
+    simulateInput(orderBook, txList, "buy Alice 100 1");
+
+    Snapshot writer(snapshotFile, transactionsFile);
+    ASSERT_TRUE(writer.save(traderBase, orderBook, txList, nextOrderId - 1, 6));
+    simulateInput(orderBook, txList, "buy Alice 100 1");
+    ASSERT_TRUE(writer.save(traderBase, orderBook, txList, nextOrderId - 1, 7));
+
+    TraderBase traders;
+    OrderBook loadedBook;
+    TransactionList loadedTxList;
+    OrderId lastOrderId = 0;
+    uint64_t journalSequence = 0;
+    Snapshot reader(snapshotFile, transactionsFile);
+    ASSERT_TRUE(reader.load(traders, loadedBook, loadedTxList, lastOrderId, journalSequence));
+
+    EXPECT_EQ(lastOrderId, nextOrderId - 1);
+    EXPECT_EQ(journalSequence, 7);
+    EXPECT_EQ(loadedBook.getFrontSellOrder(), nullptr);
+    ASSERT_NE(loadedBook.getFrontBuyOrder(), nullptr);
+    EXPECT_EQ(loadedBook.getFrontBuyOrder()->getId(), buyId);
+    EXPECT_EQ(loadedBook.getFrontBuyOrder()->getQuantity(), 2);
+    EXPECT_EQ(traders.getName(loadedBook.getFrontBuyOrder()->getTrader()), "Dave");
+    ASSERT_EQ(loadedTxList.getSize(), 2);
+    EXPECT_EQ(traders.getName(loadedTxList.getTransaction(0)->getSeller()), "Bob");
+    EXPECT_EQ(traders.getName(loadedTxList.getTransaction(1)->getSeller()), "Carl");
+    EXPECT_EQ(traders.getName(loadedTxList.getTransaction(1)->getBuyer()), "Alice");
+    EXPECT_EQ(loadedTxList.getTransaction(1)->getPricePerOne(), txList.getTransaction(1)->getPricePerOne());
+
+    {
+        std::fstream file(snapshotFile, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(-1, std::ios::end);
+        file.put('\x7f');
+    }
+    OrderBook rejectedBook;
+    TransactionList rejectedTxList;
+    EXPECT_FALSE(reader.load(traders, rejectedBook, rejectedTxList, lastOrderId, journalSequence));
+    EXPECT_EQ(rejectedBook.getFrontBuyOrder(), nullptr);
+    EXPECT_EQ(rejectedTxList.getSize(), 0);
+    std::remove(snapshotFile.c_str());
+    std::remove(transactionsFile.c_str());
+}
+
+// Test:        Seqlock readers never see a torn value
+// Input:       A writer storing 200.000 values whose two halves always match,
+//              read concurrently by another thread
+// Expected:    Every value read is consistent and the reader sees the final value
+TEST(SeqlockTest, ConsistentReads) {
+    struct Pair { uint64_t first; uint64_t second; uint64_t third; };
+    Seqlock<Pair> seqlock;
+    std::atomic<bool> done{false};
+    std::thread writer([&]() {
+        for (uint64_t i = 1; i <= 200000; ++i) {
+            seqlock.store(Pair{i, i * 3, i * 7});
+        }
+        done = true;
+    });
+    bool consistent = true;
+    Pair value;
+    while (!done) {
+        seqlock.load(value);
+        consistent = consistent && value.second == value.first * 3 && value.third == value.first * 7;
+    }
+    writer.join();
+    seqlock.load(value);
+    EXPECT_TRUE(consistent);
+    EXPECT_EQ(value.first, 200000);
+}
+
+// Test:        Readers of the transaction list only see whole batches
+// Input:       A writer appending 100.000 batches of three fills, each batch
+//              published at once, read concurrently by another thread
+// Expected:    Every read sees a multiple of three transactions, the last three
+//              from the same batch, and finally all of them
+TEST(TransactionListTest, PublishesBatches) {
+    TransactionList txList;
+    std::atomic<bool> done{false};
+    std::thread writer([&]() {
+        for (int batch = 1; batch <= 100000; ++batch) {
+            for (int fill = 0; fill < 3; ++fill) {
+                txList.appendTransaction(Transaction(batch, 100, batch, 1, 2));
+            }
+            txList.publishTransactions();
+        }
+        done = true;
+    });
+    bool consistent = true;
+    while (!done) {
+        int size = txList.getSize();
+        auto last = txList.getLastN(3);
+        consistent = consistent && size % 3 == 0;
+        if (last.size() == 3) {
+            consistent = consistent && last[0].getQuantity() == last[2].getQuantity()
+                                    && last[0].getQuantity() >= size / 3;
+        }
+    }
+    writer.join();
+    EXPECT_TRUE(consistent);
+    EXPECT_EQ(txList.getSize(), 300000);
+    EXPECT_EQ(txList.getTransaction(299999)->getQuantity(), 100000);
+    EXPECT_EQ(txList.getTransaction(0)->getQuantity(), 1);
+}
+
+// Test:        Sealed blocks of the transaction history are compressed and spilled
+// Input:       20 blocks of fills at slowly moving prices, with at most 4 sealed
+//              blocks kept in memory and the rest spilled to a file
+// Expected:    Every transaction reads back unchanged, from the ring, memory or disk,
+//              and the memory held by sealed blocks stays within the limit; once the
+//              spill file is truncated, reads of spilled blocks fail
+TEST(TransactionListTest, SpillsSealedBlocks) {
+    const std::string spillFile = "history_test.bin";
+    const size_t count = 20 * TransactionList::BLOCK_SIZE + 123;
+    auto expected = [](size_t i) {
+        return Transaction(1 + i % 50, 10000 + (i / 100) % 40, 1700000000 + i / 1000, i % 7, i % 11);
+    };
+    {
+        TransactionList txList(spillFile, 4);
+        for (size_t i = 0; i < count; ++i) {
+            txList.addTransaction(expected(i));
+        }
+        ASSERT_EQ(txList.getSize(), count);
+        txList.flush();
+        EXPECT_GT(txList.getSpilledBytes(), 0);
+        // 5 columns of 4096 mostly one-byte varints per block
+        EXPECT_LE(txList.getMemoryBytes(), 4 * 6 * TransactionList::BLOCK_SIZE);
+
+        size_t index = 0;
+        bool same = true;
+        txList.forEachTransaction(0, [&](const Transaction& tx) {
+            Transaction want = expected(index++);
+            same = same && tx.getQuantity() == want.getQuantity() && tx.getPricePerOne() == want.getPricePerOne()
+                        && tx.getDate() == want.getDate() && tx.getSeller() == want.getSeller() && tx.getBuyer() == want.getBuyer();
+        });
+        EXPECT_TRUE(same);
+        EXPECT_EQ(index, count);
+        EXPECT_EQ(txList.getTransaction(5)->getPricePerOne(), expected(5).getPricePerOne());
+        EXPECT_EQ(txList.getTransaction(count - 1)->getQuantity(), expected(count - 1).getQuantity());
+        auto last = txList.getLastN(2);
+        ASSERT_EQ(last.size(), 2);
+        EXPECT_EQ(last[0].getBuyer(), expected(count - 1).getBuyer());
+
+        // a spill file that cannot be read back fails the reads instead
+        std::filesystem::resize_file(spillFile, 0);
+        index = 0;
+        EXPECT_FALSE(txList.forEachTransaction(0, [&](const Transaction&) { ++index; }));
+        EXPECT_EQ(index, 0);
+        EXPECT_FALSE(txList.getTransaction(5).has_value());
+        EXPECT_TRUE(txList.getTransaction(count - 1).has_value());
+    }
+    // the spill file is removed with the list
+    EXPECT_FALSE(std::ifstream(spillFile).is_open());
+}
+
+// Test:        The publisher writes only the latest top of the book
+// Input:       1.000 book updates published faster than the publisher's rate
+// Expected:    After stopping, the file shows the final top buy and sell orders
+TEST(MarketDataPublisherTest, ConflatesUpdates) {
+    const std::string filename = "top_orders_test.txt";
+    OrderBook orderBook;
+    TransactionList txList;
+    MarketDataPublisher publisher(traderBase);
+    publisher.setMaxRate(10);
+    size_t book = publisher.addBook(filename);
+    publisher.start();
+    OrderId lastBuy = 0;
+    for (int i = 1; i <= 1000; ++i) {
+        lastBuy = simulateInput(orderBook, txList, "buy Alice " + std::to_string(i) + " 1");
+        publisher.publish(book, orderBook.getFrontBuyOrder(), orderBook.getFrontSellOrder());
+    }
+    publisher.stop();
+
+    std::ifstream file(filename);
+    std::string buyLine, sellLine;
+    std::getline(file, buyLine);
+    std::getline(file, sellLine);
+    EXPECT_EQ(buyLine, "Top Buy Order: " + std::to_string(lastBuy) + " 1 1000 " + std::to_string(orderBook.getFrontBuyOrder()->getDate()) + " Alice");
+    EXPECT_EQ(sellLine, "Top Sell Order: No Sell Orders");
+    std::remove(filename.c_str());
+}
+
+// Test:        Latency histogram percentiles
+// Input:       Every value from 1 to 10.000 ns recorded once
+// Expected:    Exact count, mean and max; percentiles within the 1/32 bucket precision
+TEST(StatsTest, LatencyHistogramPercentiles) {
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.getPercentile(99), 0);
+    for (int64_t value = 1; value <= 10000; ++value) {
+        histogram.record(value);
+    }
+    EXPECT_EQ(histogram.getCount(), 10000);
+    EXPECT_EQ(histogram.getMean(), 5000);
+    EXPECT_EQ(histogram.getMax(), 10000);
+    EXPECT_EQ(histogram.getPercentile(0.01), 1);
+    EXPECT_NEAR(static_cast<double>(histogram.getPercentile(50)), 5000, 5000 / 32.0);
+    EXPECT_NEAR(static_cast<double>(histogram.getPercentile(99)), 9900, 9900 / 32.0);
+    EXPECT_EQ(histogram.getPercentile(100), 10000);
+    EXPECT_EQ(formatDuration(9900), "9.9us");
+}
+
+// Test:        A large pool reservation is one slab, and fresh memory is counted in page faults
+// Input:       A pool of 64-byte objects reserving 65.536 slots (4 MiB, advised for huge
+//              pages) that then hands all of them out; 32 MiB written for the first time
+// Expected:    The pool never grows past its first slab; the minor page fault count rises
+TEST(RuntimeTest, ReservationAndPageFaults) {
+    ObjectPool<std::array<char, 64>> pool;
+    pool.reserve(65536);
+    std::vector<PoolPtr<std::array<char, 64>>> objects;
+    for (int i = 0; i < 65536; ++i) {
+        objects.push_back(pool.make());
+    }
+    EXPECT_EQ(pool.getStats().slabs, 1);
+
+    PageFaults before = getPageFaults();
+    const size_t bytes = size_t(32) << 20;
+    auto memory = std::make_unique_for_overwrite<char[]>(bytes);
+    volatile char* pages = memory.get();
+    for (size_t i = 0; i < bytes; i += 4096) {
+        pages[i] = 1;
+    }
+    EXPECT_GT(getPageFaults().minor, before.minor);
+}
+
 // Test:        Performance test by adding 100.000 orders and matching 100.000 times.
 // Input:       100.000 buy orders with quantity = 1 and price = 1
 //              and 1 order with quantity = 100.000 and price = 100.000